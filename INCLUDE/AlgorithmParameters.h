@@ -61,6 +61,9 @@ struct AlgorithmToRun
 	ProbeStyle ps;
 	bool qa;
 	unsigned int workstations;
+	unsigned short int replication;
+	unsigned short int stages;
+	bool warmFork;
 };
 
 #endif
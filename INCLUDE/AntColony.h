@@ -0,0 +1,140 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      AntColony.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the AntColony class.
+//					The purpose of the AntColony is to run the ACO and Max Min
+//					ACO routing algorithms for one thread. The pheremone and
+//					probabilities are kept in flat arrays indexed by a dense
+//					edge id, the ants are built by a pool of helper threads
+//					and every ant draws from its own counter-based random
+//					stream, so the result does not depend on the number of
+//					helper threads.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, ant colony engine of the ACO routing algorithms.
+//
+// ____________________________________________________________________________
+
+#ifndef ANT_COLONY_H
+#define ANT_COLONY_H
+
+#include <vector>
+
+#include "Edge.h"
+
+#include "QYInclude.h"
+
+#include "pthread.h"
+
+#include "boost/cstdint.hpp"
+
+using std::vector;
+
+enum ColonyPhase {
+	COLONY_CONSTRUCT,
+	COLONY_EVALUATE,
+	COLONY_SHUTDOWN
+};
+
+struct ColonyPath
+{
+	boost::uint64_t hash;
+	unsigned short int pathLength;
+	unsigned int pathStart;
+	double bestQ;
+};
+
+class AntColony
+{
+	public:
+		AntColony(unsigned short int ci);
+		~AntColony();
+
+		kShortestPathReturn* calculate_path(unsigned short int src, unsigned short int dest, unsigned short int k, bool warm);
+
+		void resetColony();
+
+		void runWorker(unsigned short int w);
+
+	private:
+		void runPhase(ColonyPhase p);
+		void runPhaseSlice(ColonyPhase p, unsigned short int w);
+
+		double initialPheremone(unsigned short int src, unsigned short int dest);
+		void generateHeuristic(unsigned short int dest);
+		void resetPheremone(double initial);
+		void loadPheremone(unsigned short int dest, double initial);
+		void storePheremone(unsigned short int dest);
+		void clampPheremone();
+		void evaporatePheremone();
+		void addPheremone(unsigned int e, unsigned int spans);
+		void generateProbabilities();
+
+		void constructAnt(unsigned int a);
+		void evaluatePath(unsigned int b, unsigned short int w);
+
+		unsigned int lookupPath(unsigned int a);
+
+		double generateZeroToOne(unsigned int a, unsigned int step);
+
+		unsigned short int controllerIndex;
+
+		unsigned short int numberOfRouters;
+		unsigned int numberOfEdges;
+
+		//Dense edge ids, the edges leaving router n are [edgeStart[n], edgeStart[n+1])
+		unsigned int *edgeStart;
+		unsigned short int *edgeDestination;
+		unsigned short int *edgeSpans;
+		Edge **edgePointer;
+
+		double *pheremone;
+		double *heuristic;
+		double *probability;
+
+		//Per ant storage, reused by every iteration
+		unsigned int antCount;
+		unsigned int *antPath;
+		unsigned short int *antLength;
+		unsigned int *antSpans;
+		int *antResult;
+		bool *antVisited;
+
+		//Unique paths seen during the current request with their best Q-factor
+		vector<ColonyPath> pathCache;
+		vector<unsigned int> pathCacheEdges;
+		vector<unsigned int> pathBatch;
+
+		Edge **evaluateBuffer;
+
+		unsigned short int currentSource;
+		unsigned short int currentDestination;
+
+		unsigned int requestCounter;
+		unsigned int iterationCounter;
+
+		//Pheremone kept for every destination between requests (ACO_warm_start)
+		double *warmPheremone;
+		double *warmTime;
+		bool *warmValid;
+
+		//Helper threads used to build and evaluate the ants
+		unsigned short int workerCount;
+		pthread_t *workers;
+		SimulationContext** workerContext;	//Own scratch space of every worker
+		pthread_mutex_t workerMutex;
+		pthread_cond_t workerStart;
+		pthread_cond_t workerDone;
+		unsigned int workerGeneration;
+		unsigned short int workersFinished;
+		ColonyPhase workerPhase;
+};
+
+#endif
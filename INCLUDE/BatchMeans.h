@@ -0,0 +1,65 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      BatchMeans.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the BatchMeans class.
+//					The BatchMeans splits the finished connection requests of
+//					one simulation into batches, keeps the blocking probability
+//					of every batch and calculates the 95% confidence interval
+//					on the blocking from the batch means while the simulation
+//					is running.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, batch means stopping rule.
+//
+// ____________________________________________________________________________
+
+#ifndef BATCH_MEANS_H
+#define BATCH_MEANS_H
+
+#include <vector>
+
+using std::vector;
+
+class BatchMeans
+{
+	public:
+		BatchMeans(unsigned int size, unsigned int minimum, double precision);
+		~BatchMeans();
+
+		void reset(unsigned int finished, unsigned int blocked);
+
+		bool update(unsigned int finished, unsigned int blocked);
+
+		inline unsigned int getBatches()
+			{ return static_cast<unsigned int>(batches.size()); };
+		inline double getMean()
+			{ return mean; };
+		inline double getHalfWidth()
+			{ return halfWidth; };
+		double getRelativeHalfWidth();
+
+	private:
+		void calculateInterval();
+
+		unsigned int batchSize;
+		unsigned int minBatches;
+		double targetPrecision;
+
+		//Counters at the end of the last complete batch
+		unsigned int lastFinished;
+		unsigned int lastBlocked;
+
+		vector<double> batches;
+
+		double mean;
+		double halfWidth;
+};
+
+#endif
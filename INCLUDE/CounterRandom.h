@@ -0,0 +1,54 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      CounterRandom.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the CounterRandom
+//					class. The CounterRandom is a Philox4x32-10 counter based
+//					random number generator. A draw is a function of a key and
+//					a counter only, so it needs no state, and the same key and
+//					counter give the same numbers on any thread.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, counter-based random streams.
+//
+// ____________________________________________________________________________
+
+#ifndef COUNTER_RANDOM_H
+#define COUNTER_RANDOM_H
+
+#include "boost/cstdint.hpp"
+
+//What the numbers are drawn for, kept in the counter so the streams never overlap
+enum RandomPurpose {
+	RANDOM_TRAFFIC,
+	RANDOM_DESTINATION,
+	RANDOM_WAVELENGTH,
+	RANDOM_WORKSTATION_ORDER,
+	NUMBER_OF_RANDOM_PURPOSES
+};
+
+//Number of 32 bit values given by each Philox block
+const unsigned int RANDOM_BLOCK_SIZE = 4;
+
+class CounterRandom
+{
+	public:
+		static boost::uint64_t makeKey(boost::uint32_t seed, boost::uint32_t stream);
+
+		static void generateBlock(boost::uint64_t key, boost::uint32_t index, RandomPurpose p,
+			boost::uint32_t draw, boost::uint32_t extra, boost::uint32_t out[RANDOM_BLOCK_SIZE]);
+
+		static void generateZeroToOne(boost::uint64_t key, boost::uint32_t index, RandomPurpose p,
+			boost::uint32_t first, unsigned int n, double* out);
+
+		static inline double toZeroToOne(boost::uint32_t x)
+			{ return (double(x) + 0.5) * (1.0 / 4294967296.0); };
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "Stats.h"
+#include "SimulationContext.h"
 
 #ifdef RUN_GUI
 #include "AllegroWrapper.h"
@@ -38,11 +39,16 @@ enum EdgeStatus {
 	EDGE_USED
 };
 
+//Link state of a free wavelength, a used one holds the session using it
+#define LINK_STATE_FREE -1
+
+struct EstablishedConnection;
+
 class Edge
 {
 	public:
 		Edge();
-		Edge(unsigned short int src, unsigned short int dest, unsigned short int spans);
+		Edge(unsigned short int src, unsigned short int dest, unsigned short int spans, unsigned short int i);
 
 		~Edge();
 
@@ -60,20 +66,38 @@ class Edge
 		inline void setNumberOfSpans(int s) 
 			{ numberOfSpans = s; };
 
+		//Dense index of the edge in the link state of the thread
+		inline unsigned short int getIndex()
+			{ return index; };
+
 		inline EdgeStatus getStatus(unsigned short int w)
-			{ return status[w]; };
+			{ return linkState[w] == LINK_STATE_FREE ? EDGE_FREE : EDGE_USED; };
 		inline int getActiveSession(unsigned short int w)
-			{ return activeSession[w]; };
+			{ return linkState[w]; };
+
+		//Row of the link state of the thread that belongs to this edge
+		inline const int* getLinkState()
+			{ return linkState; };
+		void setLinkState(int *s);
 
 		inline void setUsed(int session, unsigned short int w)
-			{ status[w] = EDGE_USED; activeSession[w] = session; };
+		{
+			linkState[w] = session; QMDirty = true; ++version;
+			if(!establishedConnections.empty())
+				markEstablishedConnections(w);
+		};
 		inline void setFree(unsigned short int w)
-			{ status[w] = EDGE_FREE; activeSession[w] = -1; degredation[w] = 0.0; };
+		{
+			linkState[w] = LINK_STATE_FREE; degredation[w] = 0.0;
+			QMPending[w] = false; QMDirty = true; ++version;
+			if(!establishedConnections.empty())
+				markEstablishedConnections(w);
+		};
 
 		void updateUsage();
 		
-		void updateQMDegredation(unsigned short int ci, unsigned int wavelength);
-		void updateQFactorStats(unsigned short int ci, unsigned int wavelength);
+		void updateQMDegredation(SimulationContext* ctx, unsigned int wavelength);
+		void updateQFactorStats(SimulationContext* ctx, unsigned int wavelength);
 
 		list <void*> establishedConnections;
 
@@ -86,18 +110,14 @@ class Edge
 		inline float getAlgorithmUsage()
 			{ return algorithmUsage; };
 		inline void resetAlgorithmUsage()
-			{ algorithmUsage = 0.0; };
-		void resetQMDegredation();
+			{ algorithmUsage = 0.0; ++version; };
 
-		inline float getQMDegredation()
-			{ return QMDegredation; };
-
-		inline float getPheremone()
-			{ return pheremone; };
-		 void resetPheremone(unsigned int ci, unsigned int spans);
+		//Changes whenever the link state read by the routing algorithms changes
+		inline unsigned int getVersion()
+			{ return version; };
+		void resetQMDegredation();
 
-		void evaporatePheremone(unsigned int ci);
-		void addPheremone(unsigned int hops, unsigned int ci);
+		float getQMDegredation(SimulationContext* ctx);
 
 #ifdef RUN_GUI
 		inline unsigned short int getMaxActualUsage()
@@ -119,26 +139,35 @@ class Edge
 			{ return stats; };
 
 		void resetEdgeStats();
+		void sampleQVariants(SimulationContext* ctx, EstablishedConnection* ec);
+		void addVariantStats(SimulationContext* ctx, EstablishedConnection* ec);
 
 		inline void insertEstablishedConnection(void* ec_void)
 			{ establishedConnections.push_back(ec_void); };
-		void removeEstablishedConnection(void* dcpe_void);
+		void removeEstablishedConnection(SimulationContext* ctx, void* dcpe_void);
+		void markEstablishedConnections(unsigned short int w);
 
 private:
 		unsigned short int sourceIndex;
 		unsigned short int destinationIndex;
 		unsigned short int numberOfSpans;
 
-		int *activeSession;
-		EdgeStatus *status;
+		unsigned short int index;
+		int *linkState;
 
 		float algorithmUsage;
 		unsigned short int actualUsage;
 
+		unsigned int version;
+
 		float QMDegredation;
 
 		double* degredation;
 
+		//Lightpaths whose degredation is recalculated on the next getQMDegredation
+		bool* QMPending;
+		bool QMDirty;
+
 #ifdef RUN_GUI
 		int r1x,r1y,r2x,r2y; //coordinates of routers
 		int r3x,r3y,r4x,r4y; //points to draw to for edge width (these change)
@@ -152,8 +181,6 @@ private:
 		BITMAP* edgeBmp;
 #endif
 		EdgeStats *stats;
-
-		float pheremone;
 };
 
 #endif
@@ -42,7 +42,11 @@ enum ErrorCodes
 	ERROR_USER_CLOSED = -19,
 	ERROR_QFACTOR_MONTIOR = -20,
 	ERROR_WAVELENGTH_ALGORITHM_IA = -21,
-	ERROR_PRIORITY_QUEUE = -22
+	ERROR_PRIORITY_QUEUE = -22,
+	ERROR_REPLICATION_RESULTS = -23,
+	ERROR_TRAFFIC_INPUT = -24,
+	ERROR_TRACE_INPUT = -25,
+	ERROR_TRACE_OUTPUT = -26
 };
 
 #endif
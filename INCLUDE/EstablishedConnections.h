@@ -33,6 +33,16 @@ struct EstablishedConnection
 	float averageQFactor;
 	vector<double> *QFactors;
 	vector<double> *QTimes;
+	vector<float> *variantQFactors;	//Q-factor of every variant for every entry of QFactors (Q_variants)
+
+	//Noise of every prefix of the path, kept up to date by ResourceManager::update_lightpath_noise
+	double *xpmRows;		//XPM of each neighbour wavelength for every prefix
+	double *fwmRows;		//FWM of each combination for every prefix
+	double *xpmPrefix;
+	double *fwmPrefix;
+	double *asePrefix;
+	bool *dirtyWaves;		//wavelengths that changed on the path since the last update
+	bool dirty;
 };
 
 #endif
@@ -31,6 +31,8 @@ using std::vector;
 enum EventType {
 	ACTIVATE_WORKSTATIONS,
 	DEACTIVATE_WORKSTATIONS,
+	NEXT_LOAD_STAGE,
+	TAKE_SNAPSHOT,
 	UPDATE_USAGE,
 	UPDATE_GUI,
 	CONNECTION_REQUEST,
@@ -44,6 +44,11 @@ class EventQueue
 		inline unsigned int getSize()
 			{ return static_cast<unsigned int>(pq.size()); };
 
+		inline double getNextTime()
+			{ return pq.top().e_time; };
+
+		void copyEvents(vector<Event> &events);
+
 	private:
 		priority_queue<Event, vector<Event>,less<vector<Event>::value_type> > pq;
 };
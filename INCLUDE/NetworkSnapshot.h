@@ -0,0 +1,53 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      NetworkSnapshot.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the datatypes of a snapshot of the
+//					warm network state. The snapshot is taken while the
+//					reference algorithm is running and the other algorithms
+//					continue from it, so they do not each start from an
+//					empty network.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, network snapshot of the warm state forks.
+//
+// ____________________________________________________________________________
+
+#ifndef NETWORK_SNAPSHOT_H
+#define NETWORK_SNAPSHOT_H
+
+#include <vector>
+
+#include "AlgorithmParameters.h"
+#include "Event.h"
+
+using std::vector;
+
+//A connection that was established and has not started to tear down yet
+struct SnapshotConnection
+{
+	vector<unsigned short int> routers;	//source of every hop followed by the destination
+	short int wavelength;
+	unsigned int session;
+	double connectionEndTime;
+};
+
+struct NetworkSnapshot
+{
+	AlgorithmToRun reference;			//the algorithm the snapshot was taken from
+	double time;
+
+	vector<SnapshotConnection> connections;
+
+	//The next request of every workstation, already drawn from its random stream
+	vector<ConnectionRequestEvent> requests;
+	vector<unsigned int> trafficCount;
+};
+
+#endif
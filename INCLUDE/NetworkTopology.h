@@ -0,0 +1,95 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      NetworkTopology.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the NetworkTopology
+//					class. The NetworkTopology holds the routers, edges,
+//					workstations and traffic demand read from the input files.
+//					It is read once and shared by all of the threads and runs,
+//					every thread only builds the objects holding its own link
+//					state from it.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, topology shared by all threads.
+//
+// ____________________________________________________________________________
+
+#ifndef NETWORK_TOPOLOGY_H
+#define NETWORK_TOPOLOGY_H
+
+#include <vector>
+
+#include "SimulationContext.h"
+
+using std::vector;
+
+class NetworkTopology
+{
+	public:
+		NetworkTopology(const char* topology, const char* wavelengths);
+		~NetworkTopology();
+
+		inline unsigned short int getNumberOfRouters()
+			{ return numberOfRouters; };
+		inline unsigned short int getNumberOfEdges()
+			{ return static_cast<unsigned short int>(edgeSource.size()); };
+		inline unsigned short int getNumberOfWorkstations()
+			{ return numberOfWorkstations; };
+
+		inline unsigned short int getEdgeSource(unsigned short int e)
+			{ return edgeSource[e]; };
+		inline unsigned short int getEdgeDestination(unsigned short int e)
+			{ return edgeDestination[e]; };
+		inline unsigned short int getEdgeSpans(unsigned short int e)
+			{ return edgeSpans[e]; };
+
+		inline unsigned short int getWorkstationParent(unsigned short int w)
+			{ return workstationParent[w]; };
+
+#ifdef RUN_GUI
+		inline int getRouterXPercent(unsigned short int r)
+			{ return routerXPercent[r]; };
+		inline int getRouterYPercent(unsigned short int r)
+			{ return routerYPercent[r]; };
+#endif
+
+		void buildDestinationTables(SimulationContext* ctx);
+		unsigned int generateDestination(unsigned short int src, double p);
+
+	private:
+		void readTopology(const char* f);
+		void readWorkstations(const char* f);
+		void readTraffic(const char* f);
+
+		void buildAliasTable(unsigned short int src, double* probs);
+
+		unsigned short int numberOfRouters;
+		unsigned short int numberOfWorkstations;
+
+		//Both directions of every link, in the order of the edge index
+		vector<unsigned short int> edgeSource;
+		vector<unsigned short int> edgeDestination;
+		vector<unsigned short int> edgeSpans;
+
+		vector<unsigned short int> workstationParent;
+
+#ifdef RUN_GUI
+		vector<int> routerXPercent;
+		vector<int> routerYPercent;
+#endif
+
+		//Demand between every two routers read from the traffic matrix (TRAFFIC_MATRIX)
+		double* demand;
+
+		//Alias table of the destinations of every router, see generateDestination
+		double* aliasProbability;
+		unsigned short int* aliasIndex;
+};
+
+#endif
@@ -7,7 +7,8 @@
 //  Project:        RWASimulator
 //
 //  Description:    The file contains the declaration of the QualityParameters
-//					struct, which are used to calculate the Q factor
+//					struct, which are used to calculate the Q factor, and of
+//					the PhysicalParameters derived from them.
 //
 //  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 //  Revision History:
@@ -19,11 +20,22 @@
 #ifndef QUALITY_PARAMS_H
 #define QUALITY_PARAMS_H
 
+//Most physical parameter variants whose Q-factor stats are kept alongside a simulation
+const unsigned short int MAX_Q_VARIANTS = 8;
+
 enum DestinationDistribution
 {
 	UNIFORM = 1,
 	DISTANCE = 2,
-	INVERSE_DISTANCE = 3
+	INVERSE_DISTANCE = 3,
+	TRAFFIC_MATRIX = 4
+};
+
+enum TraceMode
+{
+	TRACE_OFF = 0,
+	TRACE_RECORD = 1,
+	TRACE_REPLAY = 2
 };
 
 struct QualityParameters
@@ -63,6 +75,58 @@ struct QualityParameters
 	float MM_ACO_gamma;			//the min-max pheromone ratio for MM ACO
 	int MM_ACO_N_iter;			//the number of iterations for stagnation for MM ACO
 	int MM_ACO_N_reset;			//the number of reinitialization times for MM ACO
+	int ACO_threads;			//the number of threads building the ants of each ACO colony
+	bool ACO_warm_start;		//should ACO keep the pheromone between requests (1=yes,0=no)
+	float ACO_warm_interval;	//the simulation time of one evaporation step for the kept pheromone
+	int ACO_stable_iter;		//stop ACO once the best path is unchanged for this many iterations (0=never)
+	int Q_threads;				//the number of threads estimating the Q-factor of the wavelengths of a path
+	int RA_speculate;			//the number of threads calculating the paths of the next requests ahead of time (0=off)
+	bool probe_fusion;			//should the hops of one signaling message share a single event when nothing can come between them (1=yes,0=no)
+	int RA_budget_ops;			//the number of operations a routing algorithm may use per request (0=unlimited)
+	float RA_budget_time;		//the wall clock seconds a routing algorithm may use per request (0=unlimited)
+	int replications;			//the number of random seeds every simulation is run with
+	float stop_precision;		//stop the traffic once the blocking 95% half width over the mean reaches this (0=never)
+	int stop_batch_size;		//the number of finished requests in each batch of the stopping rule
+	int stop_min_batches;		//the number of batches needed before the stopping rule may stop the traffic
+	bool warmup_detect;			//remove the warm up found by MSER-5 from the statistics (1=yes,0=no)
+	int warmup_check;			//the number of MSER-5 batches in the series before the first warm up test
+	bool load_ramp;				//run the iterations of every algorithm as load stages of a single simulation (1=yes,0=no)
+	float load_ramp_settle;		//the fraction of every load stage before its statistics are collected
+	bool warm_fork;				//continue the other algorithms from a snapshot of the first one (1=yes,0=no)
+	float warm_fork_settle;		//the fraction of the traffic the first algorithm runs before the snapshot is taken
+	TraceMode trace_mode;		//0=generate the traffic, 1=also record it to OUTPUT, 2=replay INPUT/Trace-<topology>-<lambda>.bin
+	unsigned short int Q_variants;	//the number of physical parameter variants whose Q-factor stats are kept alongside (0=off)
+	float Q_variant_power[MAX_Q_VARIANTS];			//channel_power of every variant
+	float Q_variant_gamma[MAX_Q_VARIANTS];			//gamma of every variant
+	float Q_variant_noise_figure[MAX_Q_VARIANTS];	//EDFA_Noise_Figure of every variant
+};
+
+//Built once by the ResourceManager from the QualityParameters and only read
+//afterwards. Holds what the Q-factor kernels need, with the derived constants
+//already calculated.
+struct PhysicalParameters
+{
+	double channel_power;		//power per channel
+	double fwm_scale;			//2 * channel_power, applied to the summed FWM terms
+	double alpha;				//attenuation of NZDSF in each span
+	double alpha_square;		//alpha * alpha
+	double alphaL;				//alpha * L
+	double exp_alphaL;			//exp(-alpha * L)
+	double exp_2alphaL;			//exp(-2 * alpha * L)
+	double L;					//length of the NZDSF in each span
+	double D;					//dispersion of NZDSF in each span
+	double S;					//disperison slop of NZDSF in each span
+	double gamma;				//nonlinear coefficent of NZDSF in each span
+	double *lambdac;			//wavelength of each channel, c / fs
+	const float *ASE_perEDFA;	//ASE noise per EDFA
+	int nonlinear_halfwin;		//the total nonlinear_win is 2*M+1
+	int halfwavelength;			//the total wavelength is 2N+1
+	unsigned short int wavelengths;	//2N+1
+	unsigned short int variants;	//the number of physical parameter variants, see ResourceManager::estimate_Q_variants
+	double variant_power[MAX_Q_VARIANTS];			//channel_power of every variant
+	double variant_ase_scale[MAX_Q_VARIANTS];		//ASE noise of the variant over the ASE noise of the simulation
+	double variant_nonlinear_scale[MAX_Q_VARIANTS];	//XPM and FWM noise of the variant over those of the simulation
+	double variant_TH_Q[MAX_Q_VARIANTS];			//Q-factor threshold of every variant
 };
 
 #endif
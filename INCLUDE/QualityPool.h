@@ -0,0 +1,82 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      QualityPool.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the QualityPool class.
+//					The QualityPool estimates the Q-factor of every candidate
+//					wavelength of one path on a pool of helper threads, so a
+//					single simulation can use more than one core. The link
+//					state is only read while the pool is running and every
+//					wavelength has its own result, so the choice made from the
+//					results is the same as the one made one wavelength at a
+//					time.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, parallel Q-factor estimation.
+//
+// ____________________________________________________________________________
+
+#ifndef QUALITY_POOL_H
+#define QUALITY_POOL_H
+
+#include "Edge.h"
+
+#include "pthread.h"
+
+class SimulationContext;
+
+class QualityPool
+{
+	public:
+		QualityPool(unsigned short int ci, unsigned short int threads, unsigned short int wavelengths);
+		~QualityPool();
+
+		void evaluate(Edge **path, unsigned short int pathLen, const bool *candidates, SimulationContext* ctx);
+
+		inline double getQ(unsigned short int w, double *xpm, double *fwm, double *ase)
+		{
+			*xpm = xpmNoise[w];
+			*fwm = fwmNoise[w];
+			*ase = aseNoise[w];
+
+			return qFactor[w];
+		};
+
+		void runWorker(unsigned short int w);
+
+	private:
+		void evaluateSlice(unsigned short int w);
+
+		unsigned short int numberOfWavelengths;
+
+		//Results of the last evaluation, indexed by wavelength
+		double *qFactor;
+		double *xpmNoise;
+		double *fwmNoise;
+		double *aseNoise;
+
+		//Request of the current evaluation
+		Edge **currentPath;
+		unsigned short int currentLength;
+		const bool *currentCandidates;
+		SimulationContext* currentContext;
+
+		//Helper threads used to estimate the Q-factors
+		unsigned short int workerCount;
+		pthread_t *workers;
+		SimulationContext** workerContext;	//Own scratch space of every helper thread
+		pthread_mutex_t workerMutex;
+		pthread_cond_t workerStart;
+		pthread_cond_t workerDone;
+		unsigned int workerGeneration;
+		unsigned short int workersFinished;
+		bool workerShutdown;
+};
+
+#endif
@@ -30,4 +30,7 @@ struct FormattedTime {
 	float seconds;
 };
 
+//Wall clock time in seconds, used for the compute budget of the routing algorithms.
+double getWallClock();
+
 #endif
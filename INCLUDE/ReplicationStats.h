@@ -0,0 +1,59 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      ReplicationStats.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the ReplicationStats
+//					class. When every simulation is run with several random
+//					seeds (replications), the ReplicationStats collects the
+//					results of the replications and prints the mean, standard
+//					error and 95% confidence interval of each result once the
+//					last replication is done.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, statistics of independent replications.
+//
+// ____________________________________________________________________________
+
+#ifndef REPLICATION_STATS_H
+#define REPLICATION_STATS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+struct ReplicationResults
+{
+	vector<string> names;
+	vector< vector<double> > values;
+	unsigned short int count;
+};
+
+class ReplicationStats
+{
+	public:
+		ReplicationStats(unsigned short int r);
+		~ReplicationStats();
+
+		void addReplication(const string &job, const vector<string> &names, const vector<double> &values, unsigned short int ci);
+
+		static double studentT95(unsigned int df);
+
+	private:
+		void printSummary(const string &job, ReplicationResults &results, unsigned short int ci);
+
+		unsigned short int replications;
+
+		map<string,ReplicationResults> jobs;
+};
+
+#endif
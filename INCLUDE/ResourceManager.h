@@ -26,9 +26,12 @@
 #include <utility>
 #include <vector>
 
+#include "AlgorithmParameters.h"
 #include "Edge.h"
+#include "EstablishedConnections.h"
 #include "Event.h"
 #include "Router.h"
+#include "SimulationContext.h"
 
 #include "QYInclude.h"
 
@@ -46,33 +49,54 @@ struct DP_item
 	bool* waveAvailability;
 };
 
+//The part of one FWM combination that does not depend on the number of spans
+struct FWMTerm
+{
+	double coefficient;		//FWM noise of a single span
+	double phi;				//phase mismatch of a single span
+	double denominator;		//1 - cos(phi), zero when the spans add up coherently
+};
+
 class ResourceManager
 {
 	public:
 		ResourceManager();
 		~ResourceManager();
 
-		kShortestPathReturn* calculate_SP_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_LORA_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_PAR_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_IA_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int ci);
-		kShortestPathReturn* calculate_QM_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_AQoS_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_DP_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_ACO_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci);
-		kShortestPathReturn* calculate_MM_ACO_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci);
+		void updateParameters(const QualityParameters &previous);
+
+		kShortestPathReturn* calculate_SP_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_LORA_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_PAR_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_IA_path(unsigned short int src_index, unsigned short int dest_index, SimulationContext* ctx);
+		kShortestPathReturn* calculate_QM_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_AQoS_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_DP_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_ACO_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx);
+		kShortestPathReturn* calculate_MM_ACO_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx);
 
-		int choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigned short int ci);
+		int choose_wavelength(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx);
 
-		double estimate_Q(short int lambda, Edge **Path, unsigned short int pathLen, double *xpm, double *fwm, double *ase, unsigned short int ci);
+		typedef int (ResourceManager::*WavelengthHandler)(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx);
+		static const WavelengthHandler wavelengthHandlers[NUMBER_OF_WAVELENGTH_ALGORITHMS][2];
 
-		void initSPMatrix();
-		void freeSPMatrix();
+		double estimate_Q(short int lambda, Edge **Path, unsigned short int pathLen, double *xpm, double *fwm, double *ase, SimulationContext* ctx);
+		double estimate_best_Q(Edge **Path, unsigned short int pathLen, SimulationContext* ctx);
+		void estimate_Q_variants(double ase, double nonlinear, float *Q);
 
-		double path_fwm_term(int spans,double fi,double fj, double fk,double fc,int dgen);
+		void init_lightpath_noise(EstablishedConnection* ec);
+		void update_lightpath_noise(EstablishedConnection* ec, SimulationContext* ctx);
+		void free_lightpath_noise(EstablishedConnection* ec);
+		double lightpath_noise(EstablishedConnection* ec, unsigned short int hops);
+		void lightpath_Q_variants(EstablishedConnection* ec, float *Q);
+
+		double path_fwm_term(int spans, const FWMTerm &term);
 		double path_xpm_term(short int spans, short int lambda, short int wave);
 
-		void print_connection_info(CreateConnectionProbeEvent* ccpe, double Q_factor, double ase, double fwm, double xpm, unsigned short int ci);
+		inline const PhysicalParameters& getPhysicalParams()
+			{ return physical; };
+
+		void print_connection_info(CreateConnectionProbeEvent* ccpe, double Q_factor, double ase, double fwm, double xpm, SimulationContext* ctx);
 
 		double* sys_fs;
 		vector<int>* fwm_combinations;
@@ -80,12 +104,16 @@ class ResourceManager
 		unsigned short int* span_distance;
 
 	private:
-		double path_ase_noise(short int lambda, Edge **Path, unsigned short int pathLen, unsigned short int ci);
+		double path_ase_noise(short int lambda, Edge **Path, unsigned short int pathLen, SimulationContext* ctx);
+
+		double path_fwm_noise(short int lambda, Edge **Path, unsigned short int pathLen, SimulationContext* ctx);
 
-		double path_fwm_noise(short int lambda, Edge **Path, unsigned short int pathLen, unsigned short int ci);
+		double path_xpm_noise(short int lambda, Edge **Path, unsigned short int pathLen, SimulationContext* ctx);
 
-		double path_xpm_noise(short int lambda, Edge **Path, unsigned short int pathLen, unsigned short int ci);
+		void lightpath_xpm_row(EstablishedConnection* ec, short int wave, double *row, double *prefix, SimulationContext* ctx);
+		void lightpath_fwm_row(EstablishedConnection* ec, unsigned int r, double *row, double *prefix, SimulationContext* ctx);
 
+		void build_physical_parameters();
 		void build_nonlinear_datastructure();
 		void load_xpm_database(double *store,int fs_num);
 		
@@ -96,34 +124,43 @@ class ResourceManager
 		int wave_combines(double fc, double *fs,int fs_num, vector<int> &fs_coms);
 		bool can_find(int fi,int fj,int fk,vector<int> &fs_coms,int com_num);
 		int degeneracy(int fi,int fj,int fk);
+		void build_fwm_term(double fi,double fj, double fk,unsigned short int lambda,int dgen,FWMTerm &term);
 
 		double* sys_link_xpm_database;
 		int sys_fs_num;
 
-		int first_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available);
-		int first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available);
+		PhysicalParameters physical;
 
-		int random_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves);
+		int first_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available);
+		int first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available);
 
-		int most_used(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available);
+		int random_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves);
 
-		int quality_first_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves);
-		int quality_first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves);
+		int most_used(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available);
 
-		int quality_random_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves);
+		int quality_first_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves);
+		int quality_first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves);
 
-		int quality_most_used(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves);
+		int quality_random_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves);
 
-		int least_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available);
-		int most_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available);
+		int quality_most_used(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves);
+
+		int least_quality_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available);
+		int most_quality_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available);
+
+		template <WavelengthAlgorithm WA, bool QA>
+		int assign_wavelength(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx);
 
 		void precompute_fwm_fs(vector<int> &fwm_nums);
 		void precompute_fwm_combinations();
+		void build_fwm_terms(int w);
+		void free_fwm_combinations();
 
 		vector <double*>* fwm_fs;
 		vector <int*>* inter_indecies;
 
-		kShortestPathReturn** SP_paths;
+		//The FWMTerm of every combination in fwm_combinations
+		vector <FWMTerm>* fwm_terms;
 
 		void build_KSP_EdgeList();
 
@@ -132,6 +169,9 @@ class ResourceManager
 		void calc_min_spans();
 		unsigned short int calculate_span_distance(unsigned short int src, unsigned short int dest);
 
+		//Longest of the shortest distances between two routers
+		unsigned short int maxMinDistance;
+
 		short int* wave_ordering;
 
 		void generateWaveOrdering();
@@ -140,12 +180,4 @@ class ResourceManager
 		short int getUpperBound(short int w, short int n);
 };
 
-struct Ant
-{
-	Router* location;
-	Edge** path;
-	int pathlen;
-	float Q;
-};
-
 #endif
@@ -0,0 +1,104 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      RouteSpeculator.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the RouteSpeculator
+//					class. The RouteSpeculator calculates the paths of the next
+//					connection requests in the event queue on a pool of helper
+//					threads while the simulation thread handles the events that
+//					leave the link state alone. The version of every edge is
+//					kept with the paths, and the paths are only used when no
+//					edge has changed by the time the request is handled.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, speculative route calculation.
+//
+// ____________________________________________________________________________
+
+#ifndef ROUTE_SPECULATOR_H
+#define ROUTE_SPECULATOR_H
+
+#include <deque>
+#include <map>
+#include <utility>
+
+#include "Event.h"
+
+#include "QYInclude.h"
+
+#include "pthread.h"
+
+using std::deque;
+using std::map;
+using std::pair;
+
+enum SpeculationState {
+	SPECULATION_IDLE,
+	SPECULATION_QUEUED,
+	SPECULATION_RUNNING,
+	SPECULATION_DONE
+};
+
+struct SpeculatedRoute
+{
+	ConnectionRequestEvent* request;
+	SpeculationState state;
+	bool cancelled;
+	unsigned int *versions;
+	kShortestPathReturn *paths;
+};
+
+//Pending requests in the order of the event queue, by time and then session
+typedef pair<double,unsigned int> RequestKey;
+
+class RouteSpeculator
+{
+	public:
+		RouteSpeculator(unsigned short int ci, unsigned short int threads);
+		~RouteSpeculator();
+
+		void reset(unsigned short int probes);
+
+		void addRequest(double time, ConnectionRequestEvent* cre);
+		void schedule();
+		void cancel();
+		kShortestPathReturn* takeRoute(double time, ConnectionRequestEvent* cre, bool &conflict);
+
+		bool isCancelled(unsigned short int w);
+
+		void runWorker(unsigned short int w);
+
+	private:
+		bool validate(SpeculatedRoute* sr);
+		void freePaths(SpeculatedRoute* sr);
+		void removeQueued(SpeculatedRoute* sr);
+
+		unsigned short int controllerIndex;
+		unsigned short int probesToSend;
+
+		//Every edge of the thread, the speculated paths may depend on any of them
+		unsigned int numberOfEdges;
+		Edge **edges;
+
+		map<RequestKey,SpeculatedRoute*> pending;
+		deque<SpeculatedRoute*> queued;
+
+		//Helper threads, each with its own context
+		unsigned short int workerCount;
+		pthread_t *workers;
+		SimulationContext **workerContext;
+		SpeculatedRoute **workerRoute;
+		pthread_mutex_t workerMutex;
+		pthread_cond_t workerStart;
+		pthread_cond_t workerDone;
+		unsigned short int workersRunning;
+		bool workerShutdown;
+};
+
+#endif
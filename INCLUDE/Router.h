@@ -58,9 +58,6 @@ class Router
 		inline unsigned short int getIndex()
 			{ return routerIndex; };
 
-		void generateProbabilities();
-		unsigned int generateDestination(double p);
-
 #ifdef RUN_GUI
 		inline void incNumWorkstations()
 			{ ++numWorkstations; };
@@ -109,9 +106,6 @@ class Router
 		inline unsigned int getNumberOfEdges()
 			{ return static_cast<unsigned int>(edgeList.size()); };
 
-		void generateACOProbabilities(unsigned int dest);
-		Edge* chooseEdge(float p);
-
 #ifdef RUN_GUI
 		void refreshedgebmps(bool useThread);
 		inline int getXPercent()
@@ -191,7 +185,6 @@ class Router
 		void selectScreen();
 
 #endif
-		DP_node* dp_node;
 
 	private:
 		unsigned short int routerIndex;
@@ -223,9 +216,6 @@ class Router
 #endif
 
 		vector<Edge*> edgeList;
-
-		double* destinationProbs;
-		double* acoProbs;
 };
 
 #endif
@@ -0,0 +1,103 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      SimulationContext.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the SimulationContext
+//					class. The SimulationContext is handed to the routing and
+//					Q-factor code in place of a controller index. It splits the
+//					data that every simulation shares and only reads (quality
+//					parameters, nonlinear tables) from the state that belongs
+//					to the simulation running on one thread.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, per thread simulation context.
+//
+// ____________________________________________________________________________
+
+#ifndef SIMULATION_CONTEXT_H
+#define SIMULATION_CONTEXT_H
+
+#include "QualityParameters.h"
+
+#include "QYInclude.h"
+
+class ResourceManager;
+class RouteSpeculator;
+class Thread;
+
+class SimulationContext
+{
+	public:
+		SimulationContext(Thread* t, unsigned short int ci, const QualityParameters* qp, ResourceManager* r,
+			unsigned short int routers, unsigned short int wavelengths);
+		~SimulationContext();
+
+		inline Thread* getThread()
+			{ return thread; };
+		inline unsigned short int getControllerIndex()
+			{ return controllerIndex; };
+
+		inline void setSpeculation(RouteSpeculator* s, unsigned short int w)
+			{ speculator = s; speculationWorker = w; };
+		inline bool isSpeculative()
+			{ return speculator != 0; };
+		bool isSpeculationCancelled();
+
+		bool chargeRouteBudget(unsigned int ops);
+		bool getRouteBudgetCut();
+
+		inline const QualityParameters& getQualityParams()
+			{ return *quality; };
+		inline const PhysicalParameters& getPhysicalParams()
+			{ return *physical; };
+		inline ResourceManager* getResourceManager()
+			{ return rm; };
+
+		inline unsigned short int getNumberOfRouters()
+			{ return numberOfRouters; };
+		inline unsigned short int getNumberOfWavelengths()
+			{ return numberOfWavelengths; };
+
+		void initSPMatrix();
+		void freeSPMatrix();
+
+		inline kShortestPathReturn* getSPPath(unsigned short int src, unsigned short int dest)
+			{ return SP_paths == 0 ? 0 : SP_paths[src * numberOfRouters + dest]; };
+		inline bool setSPPath(unsigned short int src, unsigned short int dest, kShortestPathReturn* p)
+		{
+			if(SP_paths == 0)
+				return false;
+
+			SP_paths[src * numberOfRouters + dest] = p;
+			return true;
+		};
+
+		inline const int** getLinkStateRows()
+			{ return linkStateRows; };
+
+	private:
+		//Shared by every simulation, read only once the input files are read
+		const QualityParameters* quality;
+		const PhysicalParameters* physical;
+		ResourceManager* rm;
+		unsigned short int numberOfRouters;
+		unsigned short int numberOfWavelengths;
+
+		//Owned by the simulation running on this thread
+		Thread* thread;
+		unsigned short int controllerIndex;
+		kShortestPathReturn** SP_paths;
+		const int** linkStateRows;			//Link state of every edge of a path, used by the Q-factor calculations
+
+		//Only set on the contexts of the route speculation helper threads
+		RouteSpeculator* speculator;
+		unsigned short int speculationWorker;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #define STATS_H
 
 #include "Edge.h"
+#include "QualityParameters.h"
 
 struct GlobalStats
 {
@@ -38,6 +39,18 @@ struct GlobalStats
 	double fwmNoiseTotal;
 	double totalSetupDelay;
 	double raRunTime;
+	unsigned int acoColonies;
+	unsigned int acoIterations;
+	unsigned int acoWarmStarts;
+	unsigned int raBudgetCuts;
+	unsigned int raSpeculated;
+	unsigned int raSpeculationConflicts;
+	unsigned int fusedHops;
+	unsigned int qmRequested;
+	unsigned int qmRecalculated;
+
+	//Dropped connections of the physical parameter variants (Q_variants)
+	unsigned int variantDroppedFailures[MAX_Q_VARIANTS];
 };
 
 struct EdgeStats
@@ -54,6 +67,12 @@ struct EdgeStats
 	double totalPercentQFactor;
 	double totalTime;
 	double count;
+
+	//Totals of the physical parameter variants (Q_variants)
+	unsigned int variantDroppedConnections[MAX_Q_VARIANTS];
+	double variantInitalQFactor[MAX_Q_VARIANTS];
+	double variantAverageQFactor[MAX_Q_VARIANTS];
+	double variantPercentQFactor[MAX_Q_VARIANTS];
 };
 
 enum FailureTypes
@@ -37,17 +37,28 @@ using std::priority_queue;
 using std::vector;
 
 #include "AlgorithmParameters.h"
+#include "AntColony.h"
+#include "BatchMeans.h"
+#include "CounterRandom.h"
 #include "EstablishedConnections.h"
 #include "ErrorCodes.h"
 #include "EventQueue.h"
 #include "MessageLogger.h"
+#include "NetworkSnapshot.h"
+#include "NetworkTopology.h"
 #include "QualityParameters.h"
+#include "QualityPool.h"
+#include "ReplicationStats.h"
 #include "ResourceManager.h"
+#include "RouteSpeculator.h"
 #include "Router.h"
+#include "SimulationContext.h"
 #include "Stats.h"
+#include "TraceWorkload.h"
+#include "WarmupDetector.h"
 #include "Workstation.h"
 
-#include "boost/random.hpp"
+#include "boost/cstdint.hpp"
 
 using std::ifstream;
 using std::cout;
@@ -93,10 +104,16 @@ class Thread
 
 		int runThread(AlgorithmToRun* alg);
 
+		inline int getRunStatus()
+			{ return runCount != maxRunCount ? MORE_SIMULATIONS : COMPLETED_ALL_SIMULATIONS; };
+
 		void initPriorityQueue(unsigned short int w);
 		void initResourceManager();
 
-		inline QualityParameters getQualityParams()
+		void loadParameterSet(int argc, const char* argv[], int rc);
+		void resetParameterSet();
+
+		inline const QualityParameters& getQualityParams()
 			{ return qualityParams; };
 
 		inline void recordEvent(const string &s, bool print, unsigned short int ci)
@@ -119,11 +136,24 @@ class Thread
 			{ return numOfWavelengths; };
 		inline void setNumberOfWavelengths(unsigned short int n)
 			{	numOfWavelengths = n;	};
-		inline unsigned short int getRandomSeed()
-			{ return randomSeed; };
+		inline unsigned int getRandomSeed()
+			{ return currentSeed; };
+		unsigned int getReplicationSeed(unsigned short int r);
 
 		inline ResourceManager* getResourceManager()
 			{ return rm; };
+		inline AntColony* getAntColony()
+			{ return colony; };
+		inline QualityPool* getQualityPool()
+			{ return qualityPool; };
+		inline SimulationContext* getContext()
+			{ return context; };
+
+		kShortestPathReturn* calculatePaths(unsigned short int src, unsigned short int dest, unsigned short int probesToSend, SimulationContext* ctx);
+
+		bool chargeRouteBudget(unsigned int ops);
+		inline bool getRouteBudgetCut()
+			{ return routeBudgetCut; };
 
 		inline RoutingAlgorithm getCurrentRoutingAlgorithm()
 			{ return CurrentRoutingAlgorithm; };
@@ -133,8 +163,12 @@ class Thread
 			{ return CurrentProbeStyle; };
 		inline bool getCurrentQualityAware()
 			{ return CurrentQualityAware; };
+		inline ResourceManager::WavelengthHandler getWavelengthHandler()
+			{ return wavelengthHandler; };
 		inline unsigned int getCurrentActiveWorkstations()
 			{ return CurrentActiveWorkstations; };
+		inline unsigned short int getCurrentReplication()
+			{ return CurrentReplication; };
 		inline void setCurrentActiveWorkstations(unsigned int w)
 			{ CurrentActiveWorkstations = w;	}
 
@@ -249,23 +283,21 @@ class Thread
 		inline unsigned int getNumberOfConnections()
 			{ return numberOfConnections; };
 
-		//Random generator for zero to one
-		boost::mt19937 rng4;
-		boost::uniform_real<> *zo;
-		boost::variate_generator<boost::mt19937&, boost::uniform_real<> > *generateZeroToOne;
-
 		inline const char* getTopology()
 			{ return topology; };
 
 		inline MessageLogger* getLogger()
 			{ return logger; };
+		inline ReplicationStats* getReplicationStats()
+			{ return replicationStats; };
+		inline const vector<AlgorithmToRun*>& getForkAlgorithms()
+			{ return forkAlgorithms; };
 
 	private:
 		vector<Router*> routers;
 		vector<Workstation*> workstations;
 
-		void setTopologyParameters(const char* f);
-		void setWorkstationParameters(const char* f);
+		void buildNetwork();
 
 		EventQueue* queue;
 
@@ -273,29 +305,107 @@ class Thread
 
 		MessageLogger* logger;
 
+		ReplicationStats* replicationStats;
+
 		ResourceManager* rm;
 
+		AntColony* colony;
+
+		QualityPool* qualityPool;
+
+		RouteSpeculator* speculator;
+
+		SimulationContext* context;
+
+		//Sequential stopping rule on the blocking (stop_precision)
+		BatchMeans* batchMeans;
+		bool trafficStopped;
+		double trafficStopTime;
+
+		//Trace of the connection requests (trace_mode)
+		TraceReader* traceReader;
+		TraceRecorder* traceRecorder;
+		unsigned int traceSession;
+		char traceName[100];
+
+		//MSER-5 warm up removal (warmup_detect)
+		WarmupDetector* warmup;
+		void truncateStats(const GlobalStats &base);
+
+		//Load stages of the current simulation (load_ramp)
+		void next_load_stage();
+		unsigned short int CurrentStages;
+		unsigned short int currentStage;
+		unsigned int stageWorkstations;
+		bool stageSettled;
+		vector<double> stageBlocking;
+
+		//Warm state the other algorithms of a simulation continue from (warm_fork)
+		void take_snapshot();
+		void restoreSnapshot();
+		bool CurrentWarmFork;
+		NetworkSnapshot* warmSnapshot;
+		vector<AlgorithmToRun*> forkAlgorithms;
+
+		void clearEdgeStats();
+
+		//Compute budget of the current routing request (RA_budget_ops, RA_budget_time)
+		void startRouteBudget();
+		void stopRouteBudget();
+		unsigned int routeBudgetOps;
+		unsigned int routeBudgetLimit;
+		double routeBudgetStart;
+		double routeBudgetTime;
+		bool routeBudgetCut;
+
 		const string* RoutingAlgorithmNames[NUMBER_OF_ROUTING_ALGORITHMS];
 		const string* WavelengthAlgorithmNames[NUMBER_OF_WAVELENGTH_ALGORITHMS];
 		const string* ProbeStyleNames[NUMBER_OF_PROBE_STYLES];
 
 		void setAlgorithmParameters(const char* f, unsigned short int iterationCount);
+		void deleteAlgorithmNames();
 
 		void activate_workstations();
 		void deactivate_workstations();
+		void runEvents();
+		void resetStats();
+		void reportStats();
 		void generateTrafficEvent(unsigned int session);
+		void replayTrafficEvent();
+		void addTrafficEvent(Event* tr, ConnectionRequestEvent* tr_data);
 
 		void update_link_usage();
 
 #ifdef RUN_GUI
 		void update_gui();
 #endif
+		template <RoutingAlgorithm RA, ProbeStyle PS>
 		void connection_request(ConnectionRequestEvent* cre);
+		template <RoutingAlgorithm RA, ProbeStyle PS>
 		void create_connection_probe(CreateConnectionProbeEvent* ccpe);
+		template <RoutingAlgorithm RA, ProbeStyle PS>
 		void create_connection_confirmation(CreateConnectionConfirmationEvent* ccce);
+		template <RoutingAlgorithm RA, ProbeStyle PS>
 		void destroy_connection_probe(DestroyConnectionProbeEvent* dcpe);
+		template <RoutingAlgorithm RA, ProbeStyle PS>
 		void collision_notification(CollisionNotificationEvent* cne);
 
+		//Copies of the event handlers for one routing algorithm and probe style
+		struct EventHandlers
+		{
+			void (Thread::*connectionRequest)(ConnectionRequestEvent* cre);
+			void (Thread::*createConnectionProbe)(CreateConnectionProbeEvent* ccpe);
+			void (Thread::*createConnectionConfirmation)(CreateConnectionConfirmationEvent* ccce);
+			void (Thread::*destroyConnectionProbe)(DestroyConnectionProbeEvent* dcpe);
+			void (Thread::*collisionNotification)(CollisionNotificationEvent* cne);
+		};
+
+		static const EventHandlers eventHandlers[NUMBER_OF_ROUTING_ALGORITHMS][NUMBER_OF_PROBE_STYLES];
+
+		//Handlers of the current job, picked once in initThread
+		const EventHandlers* handlers;
+		ResourceManager::WavelengthHandler wavelengthHandler;
+
 		GlobalStats stats;
 
 		bool isLoadPrevious;
@@ -345,28 +455,39 @@ class Thread
 		ProbeStyle CurrentProbeStyle;
 		bool CurrentQualityAware;
 		unsigned int CurrentActiveWorkstations;
+		unsigned short int CurrentReplication;
 
 		QualityParameters qualityParams;
 		void setQualityParameters(const char* f);
 
 		unsigned short int randomSeed;
 
+		//Seed of the current simulation, derived from randomSeed and the replication
+		unsigned int currentSeed;
+
 		unsigned short int numberOfRouters;
 		unsigned short int numberOfWorkstations;
 		unsigned short int numberOfEdges;
 
+		//Session on every wavelength of every edge, indexed by edge index and then wavelength
+		int *linkState;
+
 		unsigned int numberOfConnections;
 
 		bool order_init;
+		unsigned int orderSeed;
 		unsigned short int* workstationOrder;
 
 		double calculateDelay(unsigned short int spans);
+		double fuseProbeHops(CreateConnectionProbeEvent* ccpe, double time);
+		bool fuseNextHop(double time);
 
 		bool sendResponse(CreateConnectionProbeEvent* probe);
 		void clearResponses(CreateConnectionProbeEvent* probe);
 		bool moreProbes(CreateConnectionProbeEvent* probe);
 		int otherResponse(CreateConnectionProbeEvent* probe);
 
+		void addEstablishedConnection(Edge **connectionPath, unsigned short int connectionLength, short int wavelength, double duration);
 		void updateQMDegredation(Edge **connectionPath, unsigned short int connectionLength, unsigned int wavelength);
 		void updateQFactorStats(Edge **connectionPath, unsigned short int connectionLength, unsigned int wavelength);
 
@@ -380,23 +501,14 @@ class Thread
 		void sendProbes(ConnectionRequestEvent *cre, kShortestPathReturn *kPath, CreateConnectionProbeEvent** probesList,
 		unsigned short int probesToSend, unsigned short int probeStart, unsigned short int probesSkipped);
 
-		//Random generator for destination router
-		boost::mt19937 rng;
-		boost::uniform_int<> *rt;
-		boost::variate_generator<boost::mt19937&, boost::uniform_int<> > *generateRandomRouter;
-
-		//Random generator for duration time
-		boost::mt19937 rng2;
-		boost::exponential_distribution<> *dt;
-		boost::variate_generator<boost::mt19937&, boost::exponential_distribution<> > *generateRandomDuration;
-
-		//Random generator for arrival interval
-		boost::mt19937 rng3;
-		boost::exponential_distribution<> *ai;
-		boost::variate_generator<boost::mt19937&, boost::exponential_distribution<> > *generateArrivalInterval;
+		//Number of requests made by every workstation, the counter of its random
+		//stream, so the traffic does not depend on the routing algorithm
+		vector<unsigned int> trafficCount;
 
+		int countParameterSets(const char* f);
 		int getKthParameterInt(char *f);
 		float getKthParameterFloat(char *f);
+		unsigned short int getKthParameterList(char *f, float *list);
 
 		int runCount;
 		int maxRunCount;
@@ -0,0 +1,111 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      TraceWorkload.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the TraceReader and
+//					TraceRecorder classes. A trace is a binary file of
+//					connection requests sorted by arrival time. The
+//					TraceRecorder writes the requests of a simulation to a
+//					trace and the TraceReader replays one, mapping a small
+//					window of the file into memory at a time so that the size
+//					of the trace does not matter.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, replay of binary arrival traces.
+//
+// ____________________________________________________________________________
+
+#ifndef TRACE_WORKLOAD_H
+#define TRACE_WORKLOAD_H
+
+#include <stdio.h>
+
+#include "boost/cstdint.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+//The file starts with a TraceHeader followed by the TraceRecords, all little endian
+const char TRACE_MAGIC[4] = {'R','W','A','T'};
+const boost::uint32_t TRACE_VERSION = 1;
+
+//Bytes of the trace mapped into memory at a time
+const boost::uint64_t TRACE_WINDOW_SIZE = 16 * 1024 * 1024;
+
+struct TraceHeader
+{
+	char magic[4];
+	boost::uint32_t version;
+	boost::uint32_t recordSize;
+	boost::uint32_t reserved;
+};
+
+struct TraceRecord
+{
+	double arrivalTime;
+	double holdingTime;
+	boost::uint16_t sourceRouterIndex;
+	boost::uint16_t destinationRouterIndex;
+	boost::uint32_t reserved;
+};
+
+class TraceReader
+{
+	public:
+		TraceReader(const char* f);
+		~TraceReader();
+
+		void rewind();
+
+		bool next(TraceRecord &r);
+
+		inline boost::uint64_t getNumberOfRecords()
+			{ return numberOfRecords; };
+
+	private:
+		void mapWindow(boost::uint64_t offset);
+		void unmapWindow();
+
+#ifdef _WIN32
+		HANDLE file;
+		HANDLE mapping;
+#else
+		int file;
+#endif
+
+		boost::uint64_t fileSize;
+		boost::uint64_t granularity;
+
+		boost::uint64_t numberOfRecords;
+		boost::uint64_t nextRecord;
+
+		char* window;
+		boost::uint64_t windowStart;
+		boost::uint64_t windowLength;
+};
+
+class TraceRecorder
+{
+	public:
+		TraceRecorder(const char* f);
+		~TraceRecorder();
+
+		void record(double arrival, double holding, unsigned short int src, unsigned short int dest);
+
+		inline boost::uint64_t getNumberOfRecords()
+			{ return numberOfRecords; };
+
+	private:
+		FILE* file;
+
+		boost::uint64_t numberOfRecords;
+};
+
+#endif
@@ -0,0 +1,75 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      WarmupDetector.h
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the declaration of the WarmupDetector
+//					class. The WarmupDetector keeps the blocking of every five
+//					finished connection requests from the start of a simulation
+//					and uses the MSER-5 rule to find where the empty network
+//					transient ends, so the statistics from before that point
+//					can be removed.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, MSER-5 warm up detection.
+//
+// ____________________________________________________________________________
+
+#ifndef WARMUP_DETECTOR_H
+#define WARMUP_DETECTOR_H
+
+#include <vector>
+
+#include "Edge.h"
+
+using std::vector;
+
+//Number of finished requests averaged into each observation of MSER-5
+const unsigned int MSER_BATCH_SIZE = 5;
+
+class WarmupDetector
+{
+	public:
+		WarmupDetector(unsigned int check);
+		~WarmupDetector();
+
+		void reset();
+
+		bool update(unsigned int finished, unsigned int blocked, const GlobalStats &s, double time);
+
+		inline bool getDetected()
+			{ return detected; };
+		inline unsigned int getTruncationRequests()
+			{ return truncationRequests; };
+		inline double getTruncationTime()
+			{ return truncationTime; };
+		inline const GlobalStats& getTruncationStats()
+			{ return truncationStats; };
+
+	private:
+		unsigned int mser();
+
+		unsigned int firstCheck;
+		unsigned int nextCheck;
+
+		//Counters at the end of the last complete batch
+		unsigned int lastFinished;
+		unsigned int lastBlocked;
+
+		//Blocking of every batch with the statistics and time at its end
+		vector<double> batches;
+		vector<GlobalStats> snapshots;
+		vector<double> times;
+
+		bool detected;
+		unsigned int truncationRequests;
+		double truncationTime;
+		GlobalStats truncationStats;
+};
+
+#endif
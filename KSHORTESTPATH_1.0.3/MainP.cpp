@@ -7,13 +7,20 @@ using namespace asu_emit_qyan;
 
 #ifdef __GNUC__ 
 	extern "C" void calc_k_shortest_paths(const kShortestPathParms &params, kShortestPathReturn* retVal);
+	extern "C" void calc_k_shortest_paths_budget(const kShortestPathParms &params, kShortestPathReturn* retVal, kShortestPathBudget budget, void* budgetData);
 #else
 	extern "C" __declspec(dllexport) void calc_k_shortest_paths(const kShortestPathParms &params, kShortestPathReturn* retVal);
+	extern "C" __declspec(dllexport) void calc_k_shortest_paths_budget(const kShortestPathParms &params, kShortestPathReturn* retVal, kShortestPathBudget budget, void* budgetData);
 #endif
 
 void copyResults(vector<CQYDirectedPath*> &topK_shortest_paths, const kShortestPathParms &params, kShortestPathReturn* retVal, bool dijkstra);
 
 void calc_k_shortest_paths(const kShortestPathParms &params, kShortestPathReturn* retVal)
+{
+	calc_k_shortest_paths_budget(params, retVal, NULL, NULL);
+}
+
+void calc_k_shortest_paths_budget(const kShortestPathParms &params, kShortestPathReturn* retVal, kShortestPathBudget budget, void* budgetData)
 {
 	CQYDirectedGraph dg(params);
 
@@ -34,6 +41,8 @@ void calc_k_shortest_paths(const kShortestPathParms &params, kShortestPathReturn
 	{
 		CQYKShortestPaths ksp(dg, params.src_node, params.dest_node, params.k_paths);
 
+		ksp.SetBudget(budget, budgetData);
+
 		vector<CQYDirectedPath*> topK_shortest_paths = ksp.GetTopKShortestPaths();
 
 		copyResults(topK_shortest_paths, params, retVal, false);
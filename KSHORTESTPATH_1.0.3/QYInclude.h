@@ -16,6 +16,9 @@ struct kShortestPathParms {
 	kShortestPathEdges *edge_list;	
 };
 
+//Returns true once the caller's compute budget has run out.
+typedef bool (*kShortestPathBudget)(void* data);
+
 struct kShortestPathReturn {
 	unsigned short int *pathinfo;
 	float *pathcost;
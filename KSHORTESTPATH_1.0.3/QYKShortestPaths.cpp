@@ -41,6 +41,8 @@ namespace asu_emit_qyan
 	{
 		m_pIntermediateGraph = NULL;
 		m_pShortestPath4IntermediateGraph = NULL;
+		m_pBudget = NULL;
+		m_pBudgetData = NULL;
 	}
 
 	CQYKShortestPaths::~CQYKShortestPaths()
@@ -61,6 +63,15 @@ namespace asu_emit_qyan
 		}
 	}
 
+	/************************************************************************/
+	/* Set the budget of the caller (added by Tim Hahn).
+	/************************************************************************/
+	void CQYKShortestPaths::SetBudget(kShortestPathBudget pBudget, void* pBudgetData)
+	{
+		m_pBudget = pBudget;
+		m_pBudgetData = pBudgetData;
+	}
+
 	/************************************************************************/
 	/* Get the top k shortest paths.
 	/************************************************************************/
@@ -117,6 +128,11 @@ namespace asu_emit_qyan
 			if(m_vTopShortestPaths.size() == m_nTopK)
 				break;
 
+			//Budget check added by Tim Hahn. Once the budget of the caller runs out,
+			//return the paths that have been found so far.
+			if(m_pBudget != NULL && m_pBudget(m_pBudgetData) == true)
+				break;
+
 			++cur_path_id;
 
 			// initiate temporal variables
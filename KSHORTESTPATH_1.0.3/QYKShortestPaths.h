@@ -34,6 +34,7 @@
 #endif // _MSC_VER > 1000
 
 #include "QYShortestPath.h"
+#include "QYInclude.h"
 
 namespace asu_emit_qyan
 {
@@ -47,6 +48,8 @@ namespace asu_emit_qyan
 
 		vector<CQYDirectedPath*> GetTopKShortestPaths();
 
+		void SetBudget(kShortestPathBudget pBudget, void* pBudgetData);
+
 	private: // methods
 
 		void _Init();
@@ -76,6 +79,10 @@ namespace asu_emit_qyan
 
 		// index for node where the path derives from others
 		map<int, int> m_pathDeviatedNodeMap;
+
+		// budget of the caller, checked after each path is found
+		kShortestPathBudget m_pBudget;
+		void* m_pBudgetData;
 	}; 
 }
 
@@ -0,0 +1,970 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      AntColony.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the AntColony class.
+//					The purpose of the AntColony is to run the ACO and Max Min
+//					ACO routing algorithms for one thread. The pheremone and
+//					probabilities are kept in flat arrays indexed by a dense
+//					edge id, the ants are built by a pool of helper threads
+//					and every ant draws from its own counter-based random
+//					stream, so the result does not depend on the number of
+//					helper threads.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, ant colony engine of the ACO routing algorithms.
+//
+// ____________________________________________________________________________
+
+#include "AntColony.h"
+#include "ErrorCodes.h"
+#include "Thread.h"
+
+#include <cmath>
+#include <limits>
+
+extern Thread* threadZero;
+extern Thread** threads;
+
+struct ColonyWorker
+{
+	AntColony* colony;
+	unsigned short int index;
+};
+
+void *runColonyWorker(void* n);
+
+static boost::uint64_t mixBits(boost::uint64_t x);
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	AntColony
+// Description:		Builds the dense edge ids from the routers of
+//					the thread and starts the helper threads.
+//
+///////////////////////////////////////////////////////////////////
+AntColony::AntColony(unsigned short int ci)
+{
+	controllerIndex = ci;
+
+	numberOfRouters = threadZero->getNumberOfRouters();
+	numberOfEdges = 0;
+
+	edgeStart = new unsigned int[numberOfRouters + 1];
+
+	for(unsigned short int n = 0; n < numberOfRouters; ++n)
+	{
+		edgeStart[n] = numberOfEdges;
+		numberOfEdges += threads[ci]->getRouterAt(n)->getNumberOfEdges();
+	}
+
+	edgeStart[numberOfRouters] = numberOfEdges;
+
+	edgeDestination = new unsigned short int[numberOfEdges];
+	edgeSpans = new unsigned short int[numberOfEdges];
+	edgePointer = new Edge*[numberOfEdges];
+
+	pheremone = new double[numberOfEdges];
+	heuristic = new double[numberOfEdges];
+	probability = new double[numberOfEdges];
+
+	for(unsigned short int n = 0; n < numberOfRouters; ++n)
+	{
+		for(unsigned int e = edgeStart[n]; e < edgeStart[n+1]; ++e)
+		{
+			edgePointer[e] = threads[ci]->getRouterAt(n)->getEdgeByIndex(e - edgeStart[n]);
+			edgeDestination[e] = edgePointer[e]->getDestinationIndex();
+			edgeSpans[e] = edgePointer[e]->getNumberOfSpans();
+		}
+	}
+
+	antCount = threadZero->getQualityParams().ACO_ants;
+
+	antPath = new unsigned int[antCount * (numberOfRouters - 1)];
+	antLength = new unsigned short int[antCount];
+	antSpans = new unsigned int[antCount];
+	antResult = new int[antCount];
+	antVisited = new bool[antCount * numberOfRouters];
+
+	requestCounter = 0;
+	iterationCounter = 0;
+
+	warmPheremone = 0;
+	warmTime = 0;
+	warmValid = 0;
+
+	if(threadZero->getQualityParams().ACO_warm_start == true)
+	{
+		warmPheremone = new double[numberOfRouters * numberOfEdges];
+		warmTime = new double[numberOfRouters];
+		warmValid = new bool[numberOfRouters];
+	}
+
+	resetColony();
+
+	workerCount = threadZero->getQualityParams().ACO_threads;
+
+	if(workerCount < 1)
+		workerCount = 1;
+
+	evaluateBuffer = new Edge*[workerCount * (numberOfRouters - 1)];
+
+	workerContext = new SimulationContext*[workerCount];
+
+	for(unsigned short int w = 0; w < workerCount; ++w)
+	{
+		workerContext[w] = new SimulationContext(threads[controllerIndex],controllerIndex,&threadZero->getQualityParams(),
+			threadZero->getResourceManager(),threadZero->getNumberOfRouters(),threadZero->getNumberOfWavelengths());
+	}
+
+	workerGeneration = 0;
+	workersFinished = 0;
+	workerPhase = COLONY_CONSTRUCT;
+	workers = 0;
+
+	if(workerCount > 1)
+	{
+		pthread_mutex_init(&workerMutex,NULL);
+		pthread_cond_init(&workerStart,NULL);
+		pthread_cond_init(&workerDone,NULL);
+
+		workers = new pthread_t[workerCount - 1];
+
+		for(unsigned short int w = 1; w < workerCount; ++w)
+		{
+			ColonyWorker* cw = new ColonyWorker;
+			cw->colony = this;
+			cw->index = w;
+
+			pthread_create(&workers[w-1],NULL,runColonyWorker,cw);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~AntColony
+// Description:		Stops the helper threads and frees the arrays.
+//
+///////////////////////////////////////////////////////////////////
+AntColony::~AntColony()
+{
+	if(workerCount > 1)
+	{
+		pthread_mutex_lock(&workerMutex);
+		workerPhase = COLONY_SHUTDOWN;
+		++workerGeneration;
+		pthread_cond_broadcast(&workerStart);
+		pthread_mutex_unlock(&workerMutex);
+
+		for(unsigned short int w = 1; w < workerCount; ++w)
+			pthread_join(workers[w-1],NULL);
+
+		delete[] workers;
+
+		pthread_cond_destroy(&workerDone);
+		pthread_cond_destroy(&workerStart);
+		pthread_mutex_destroy(&workerMutex);
+	}
+
+	delete[] edgeStart;
+	delete[] edgeDestination;
+	delete[] edgeSpans;
+	delete[] edgePointer;
+
+	delete[] pheremone;
+	delete[] heuristic;
+	delete[] probability;
+
+	delete[] antPath;
+	delete[] antLength;
+	delete[] antSpans;
+	delete[] antResult;
+	delete[] antVisited;
+
+	delete[] evaluateBuffer;
+
+	for(unsigned short int w = 0; w < workerCount; ++w)
+		delete workerContext[w];
+
+	delete[] workerContext;
+
+	delete[] warmPheremone;
+	delete[] warmTime;
+	delete[] warmValid;
+
+	pathCache.clear();
+	pathCacheEdges.clear();
+	pathBatch.clear();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	calculate_path
+// Description:		Runs one colony from source to destination and
+//					returns the k best unique paths found by the ants.
+//					A warm colony starts from the pheremone left by
+//					the last request to the same destination.
+//
+///////////////////////////////////////////////////////////////////
+kShortestPathReturn* AntColony::calculate_path(unsigned short int src, unsigned short int dest, unsigned short int k, bool warm)
+{
+	double alpha = threadZero->getQualityParams().DP_alpha;
+	double TH_Q = threadZero->getQualityParams().TH_Q;
+
+	unsigned short int* span_distance = threadZero->getResourceManager()->span_distance;
+
+	double l_exp = (double(threadZero->getMaxSpans()) + double(span_distance[src * numberOfRouters + dest])) / 2.0;
+	double Q_exp = 10.0 * log10(threadZero->getQualityParams().channel_power/sqrt(l_exp * threadZero->getQualityParams().ASE_perEDFA[threadZero->getQualityParams().halfwavelength]));
+
+	RoutingAlgorithm ra = threads[controllerIndex]->getCurrentRoutingAlgorithm();
+
+	kShortestPathReturn* kSP_return = new kShortestPathReturn();
+
+	kSP_return->pathcost = new float[k];
+	kSP_return->pathlen = new unsigned short int[k];
+	kSP_return->pathinfo = new unsigned short int[k * numberOfRouters - 1];
+
+	for(unsigned int k1 = 0; k1 < k; ++k1)
+	{
+		kSP_return->pathcost[k1] = 0.0;
+		kSP_return->pathlen[k1] = 0;
+	}
+
+	currentSource = src;
+	currentDestination = dest;
+
+	++requestCounter;
+	iterationCounter = 0;
+
+	//The network does not change while the colony runs, so the Q-factor
+	//of a path only needs to be computed the first time an ant finds it.
+	pathCache.clear();
+	pathCacheEdges.clear();
+
+	double initial = initialPheremone(src,dest);
+
+	generateHeuristic(dest);
+
+	if(warm == true && warmPheremone != 0 && warmValid[dest] == true)
+	{
+		loadPheremone(dest,initial);
+
+		++threads[controllerIndex]->getGlobalStats().acoWarmStarts;
+	}
+	else
+	{
+		resetPheremone(initial);
+	}
+
+	generateProbabilities();
+
+	unsigned int stableIterations = 0;
+	unsigned short int bestLength = 0;
+	unsigned short int *bestPath = new unsigned short int[numberOfRouters - 1];
+
+	for(unsigned int i = 0; i < static_cast<unsigned int>(threadZero->getQualityParams().MM_ACO_N_iter); ++i)
+	{
+		++iterationCounter;
+
+		runPhase(COLONY_CONSTRUCT);
+
+		pathBatch.clear();
+
+		for(unsigned int a = 0; a < antCount; ++a)
+		{
+			if(antLength[a] > 0)
+				antResult[a] = lookupPath(a);
+			else
+				antResult[a] = -1;
+		}
+
+		runPhase(COLONY_EVALUATE);
+
+		for(unsigned int a = 0; a < antCount; ++a)
+		{
+			if(antResult[a] < 0)
+				continue;
+
+			double bestQ = pathCache[antResult[a]].bestQ;
+			float pathWeight = float((1.0 - alpha) * (bestQ / Q_exp) + alpha * l_exp / double(antSpans[a]));
+
+			if(pathWeight > kSP_return->pathcost[k-1] && bestQ >= TH_Q)
+			{
+				unsigned int *path = &antPath[a * (numberOfRouters - 1)];
+
+				//Check for duplicates....we need to keep k distinct paths!
+				bool uniqueK = true;
+
+				for(unsigned int k0 = 0; k0 < k && uniqueK == true; ++k0)
+				{
+					if(kSP_return->pathlen[k0] != antLength[a] + 1)
+						continue;
+
+					bool same = true;
+
+					for(unsigned int r = 0; r < antLength[a]; ++r)
+					{
+						if(kSP_return->pathinfo[k0 * (numberOfRouters - 1) + r + 1] != edgeDestination[path[r]])
+						{
+							same = false;
+							break;
+						}
+					}
+
+					if(same == true)
+						uniqueK = false;
+				}
+
+				//We need to add unique paths only.
+				if(uniqueK == true)
+				{
+					if(ra == MAX_MIN_ACO)
+					{
+						i = 0;
+					}
+
+					//Calculate where to insert into the dest_node structure
+					unsigned int k1 = k - 1;
+					unsigned int k2 = 0;
+
+					while(k1 > 0 && pathWeight > kSP_return->pathcost[k1-1])
+					{
+						--k1;
+					}
+
+					k2 = k - 1;
+
+					while(k2 > k1)
+					{
+						for(unsigned int n = 0; n < static_cast<unsigned int>(numberOfRouters - 1); ++n)
+						{
+							kSP_return->pathinfo[k2 * (numberOfRouters - 1) + n] =
+								kSP_return->pathinfo[(k2-1) * (numberOfRouters - 1) + n];
+						}
+
+						kSP_return->pathlen[k2] = kSP_return->pathlen[k2-1];
+						kSP_return->pathcost[k2] = kSP_return->pathcost[k2-1];
+
+						--k2;
+					}
+
+					//Insert where appropriate
+					kSP_return->pathinfo[k1 * (numberOfRouters - 1)] = src;
+
+					for(unsigned int n = 0; n < antLength[a]; ++n)
+					{
+						kSP_return->pathinfo[k1 * (numberOfRouters - 1) + n + 1] = edgeDestination[path[n]];
+					}
+
+					kSP_return->pathlen[k1] = antLength[a] + 1;
+					kSP_return->pathcost[k1] = pathWeight;
+				}
+			}
+		}
+
+		evaporatePheremone();
+
+		if(ra == ACO)
+		{
+			for(unsigned int a2 = 0; a2 < antCount; ++a2)
+			{
+				for(unsigned int n2 = 0; n2 < antLength[a2]; ++n2)
+				{
+					addPheremone(antPath[a2 * (numberOfRouters - 1) + n2],antSpans[a2]);
+				}
+			}
+		}
+		else if(ra == MAX_MIN_ACO && kSP_return->pathlen[0] > 0)
+		{
+			unsigned int spans = 0;
+			unsigned int *best = new unsigned int[kSP_return->pathlen[0] - 1];
+
+			for(unsigned int n1 = 0; n1 < static_cast<unsigned int>(kSP_return->pathlen[0] - 1); ++n1)
+			{
+				unsigned short int from = kSP_return->pathinfo[n1];
+				unsigned short int to = kSP_return->pathinfo[n1+1];
+
+				for(unsigned int e = edgeStart[from]; e < edgeStart[from+1]; ++e)
+				{
+					if(edgeDestination[e] == to)
+					{
+						best[n1] = e;
+						break;
+					}
+				}
+
+				spans += edgeSpans[best[n1]];
+			}
+
+			for(unsigned int n2 = 0; n2 < static_cast<unsigned int>(kSP_return->pathlen[0] - 1); ++n2)
+			{
+				addPheremone(best[n2],spans);
+			}
+
+			delete[] best;
+		}
+
+		generateProbabilities();
+
+		//Stop once the best path has not changed for ACO_stable_iter iterations,
+		//an iteration without a path to the destination is never stable.
+		bool stable = (kSP_return->pathlen[0] > 0 && bestLength == kSP_return->pathlen[0]);
+
+		for(unsigned int n = 0; n < bestLength && stable == true; ++n)
+		{
+			if(bestPath[n] != kSP_return->pathinfo[n])
+				stable = false;
+		}
+
+		if(stable == true)
+		{
+			++stableIterations;
+		}
+		else
+		{
+			stableIterations = 0;
+			bestLength = kSP_return->pathlen[0];
+
+			for(unsigned int n = 0; n < bestLength; ++n)
+				bestPath[n] = kSP_return->pathinfo[n];
+		}
+
+		if(threadZero->getQualityParams().ACO_stable_iter > 0 &&
+			stableIterations >= static_cast<unsigned int>(threadZero->getQualityParams().ACO_stable_iter))
+		{
+			break;
+		}
+
+		//Stop once the compute budget of the request has run out, every ant is one operation.
+		if(threads[controllerIndex]->chargeRouteBudget(antCount) == true)
+		{
+			break;
+		}
+	}
+
+	delete[] bestPath;
+
+	++threads[controllerIndex]->getGlobalStats().acoColonies;
+	threads[controllerIndex]->getGlobalStats().acoIterations += iterationCounter;
+
+	if(warm == true && warmPheremone != 0)
+	{
+		storePheremone(dest);
+	}
+
+	for(unsigned int k1 = 0; k1 < k; ++k1)
+	{
+		if(kSP_return->pathlen[k1] == 0 && ra == ACO)
+		{
+			kSP_return->pathcost[k1] = std::numeric_limits<float>::infinity();
+			kSP_return->pathlen[k1] = std::numeric_limits<int>::infinity();
+		}
+	}
+
+	return kSP_return;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runPhase
+// Description:		Runs one phase of the colony on this thread and
+//					on every helper thread, returning once all of
+//					them are finished.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::runPhase(ColonyPhase p)
+{
+	if(workerCount == 1)
+	{
+		runPhaseSlice(p,0);
+		return;
+	}
+
+	pthread_mutex_lock(&workerMutex);
+	workerPhase = p;
+	workersFinished = 0;
+	++workerGeneration;
+	pthread_cond_broadcast(&workerStart);
+	pthread_mutex_unlock(&workerMutex);
+
+	runPhaseSlice(p,0);
+
+	pthread_mutex_lock(&workerMutex);
+
+	while(workersFinished < workerCount - 1)
+		pthread_cond_wait(&workerDone,&workerMutex);
+
+	pthread_mutex_unlock(&workerMutex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runPhaseSlice
+// Description:		Runs the share of the phase assigned to worker w.
+//					Every ant and path has a fixed owner, and each
+//					ant only writes to its own storage.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::runPhaseSlice(ColonyPhase p, unsigned short int w)
+{
+	if(p == COLONY_CONSTRUCT)
+	{
+		for(unsigned int a = w; a < antCount; a += workerCount)
+			constructAnt(a);
+	}
+	else if(p == COLONY_EVALUATE)
+	{
+		for(unsigned int b = w; b < pathBatch.size(); b += workerCount)
+			evaluatePath(b,w);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runWorker
+// Description:		Main loop of a helper thread, waits for a new
+//					phase and runs its share of it.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::runWorker(unsigned short int w)
+{
+	unsigned int seenGeneration = 0;
+
+	while(true)
+	{
+		pthread_mutex_lock(&workerMutex);
+
+		while(workerGeneration == seenGeneration)
+			pthread_cond_wait(&workerStart,&workerMutex);
+
+		seenGeneration = workerGeneration;
+		ColonyPhase p = workerPhase;
+
+		pthread_mutex_unlock(&workerMutex);
+
+		if(p == COLONY_SHUTDOWN)
+			return;
+
+		runPhaseSlice(p,w);
+
+		pthread_mutex_lock(&workerMutex);
+
+		++workersFinished;
+
+		if(workersFinished == workerCount - 1)
+			pthread_cond_signal(&workerDone);
+
+		pthread_mutex_unlock(&workerMutex);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	constructAnt
+// Description:		Walks ant a from the source to the destination,
+//					starting over from the source when it hits a
+//					loop. An ant that runs out of hops is dropped.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::constructAnt(unsigned int a)
+{
+	unsigned int *path = &antPath[a * (numberOfRouters - 1)];
+	bool *visited = &antVisited[a * numberOfRouters];
+
+	unsigned short int location = currentSource;
+	unsigned short int length = 0;
+	unsigned int step = 0;
+
+	for(unsigned short int n = 0; n < numberOfRouters; ++n)
+		visited[n] = false;
+
+	visited[currentSource] = true;
+
+	while(location != currentDestination && length + 1 < numberOfRouters - 1)
+	{
+		double p = generateZeroToOne(a,step++);
+
+		unsigned int e = edgeStart[location];
+
+		while(e + 1 < edgeStart[location+1] && p >= probability[e])
+			++e;
+
+		location = edgeDestination[e];
+		path[length] = e;
+		++length;
+
+		if(visited[location] == true)
+		{
+			for(unsigned short int n = 0; n < numberOfRouters; ++n)
+				visited[n] = false;
+
+			visited[currentSource] = true;
+
+			location = currentSource;
+			length = 0;
+		}
+		else
+		{
+			visited[location] = true;
+		}
+	}
+
+	if(location != currentDestination)
+		length = 0;
+
+	unsigned int spans = 0;
+
+	for(unsigned short int r = 0; r < length; ++r)
+		spans += edgeSpans[path[r]];
+
+	antLength[a] = length;
+	antSpans[a] = spans;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	lookupPath
+// Description:		Returns the cache entry for the path of ant a,
+//					adding it to the batch of paths to evaluate
+//					when it has not been seen before.
+//
+///////////////////////////////////////////////////////////////////
+unsigned int AntColony::lookupPath(unsigned int a)
+{
+	unsigned int *path = &antPath[a * (numberOfRouters - 1)];
+
+	boost::uint64_t hash = antLength[a];
+
+	for(unsigned short int r = 0; r < antLength[a]; ++r)
+		hash = mixBits(hash ^ path[r]);
+
+	for(unsigned int c = 0; c < pathCache.size(); ++c)
+	{
+		if(pathCache[c].hash != hash || pathCache[c].pathLength != antLength[a])
+			continue;
+
+		bool same = true;
+
+		for(unsigned short int r = 0; r < antLength[a]; ++r)
+		{
+			if(pathCacheEdges[pathCache[c].pathStart + r] != path[r])
+			{
+				same = false;
+				break;
+			}
+		}
+
+		if(same == true)
+			return c;
+	}
+
+	ColonyPath cp;
+	cp.hash = hash;
+	cp.pathLength = antLength[a];
+	cp.pathStart = static_cast<unsigned int>(pathCacheEdges.size());
+	cp.bestQ = 0.0;
+
+	for(unsigned short int r = 0; r < antLength[a]; ++r)
+		pathCacheEdges.push_back(path[r]);
+
+	pathCache.push_back(cp);
+	pathBatch.push_back(static_cast<unsigned int>(pathCache.size() - 1));
+
+	return static_cast<unsigned int>(pathCache.size() - 1);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	evaluatePath
+// Description:		Computes the best Q-factor over the free
+//					wavelengths of the b-th path in the batch.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::evaluatePath(unsigned int b, unsigned short int w)
+{
+	ColonyPath &cp = pathCache[pathBatch[b]];
+	Edge **path = &evaluateBuffer[w * (numberOfRouters - 1)];
+
+	for(unsigned short int r = 0; r < cp.pathLength; ++r)
+		path[r] = edgePointer[pathCacheEdges[cp.pathStart + r]];
+
+	//The workers evaluate their paths at the same time, each one with its own context
+	SimulationContext* ctx = workerContext[w];
+
+	cp.bestQ = ctx->getResourceManager()->estimate_best_Q(path,cp.pathLength,ctx);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	resetColony
+// Description:		Forgets everything learned by earlier requests,
+//					called at the start of every simulation run.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::resetColony()
+{
+	requestCounter = 0;
+	iterationCounter = 0;
+
+	if(warmValid != 0)
+	{
+		for(unsigned short int d = 0; d < numberOfRouters; ++d)
+		{
+			warmValid[d] = false;
+			warmTime[d] = 0.0;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	initialPheremone
+// Description:		Returns the initial pheremone level of a colony
+//
+///////////////////////////////////////////////////////////////////
+double AntColony::initialPheremone(unsigned short int src, unsigned short int dest)
+{
+	if(threads[controllerIndex]->getCurrentRoutingAlgorithm() == ACO)
+	{
+		return double(threadZero->getQualityParams().ACO_ants) /
+			double(threadZero->getResourceManager()->span_distance[src * numberOfRouters + dest]);
+	}
+
+	return 1.0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateHeuristic
+// Description:		Computes the heuristic information of every edge
+//					for the destination.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::generateHeuristic(unsigned short int dest)
+{
+	unsigned short int* span_distance = threadZero->getResourceManager()->span_distance;
+
+	double beta = threadZero->getQualityParams().ACO_beta;
+
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+	{
+		if(edgeDestination[e] != dest)
+			heuristic[e] = pow(1.0 / double(span_distance[edgeDestination[e] * numberOfRouters + dest]),beta);
+		else
+			heuristic[e] = 1.0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	resetPheremone
+// Description:		Resets the pheremone levels to the initial value
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::resetPheremone(double initial)
+{
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+		pheremone[e] = initial;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	loadPheremone
+// Description:		Loads the pheremone stored for the destination.
+//					The evaporation since the last request is applied
+//					here in one step: every ACO_warm_interval seconds
+//					of simulation time moves the level a factor rho
+//					of the way back to the initial value.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::loadPheremone(unsigned short int dest, double initial)
+{
+	double *stored = &warmPheremone[dest * numberOfEdges];
+
+	double steps = (threads[controllerIndex]->getGlobalTime() - warmTime[dest]) /
+		threadZero->getQualityParams().ACO_warm_interval;
+	double factor = pow(1.0 - threadZero->getQualityParams().ACO_rho,steps);
+
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+		pheremone[e] = initial + (stored[e] - initial) * factor;
+
+	clampPheremone();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	storePheremone
+// Description:		Saves the pheremone for the next request to the
+//					same destination.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::storePheremone(unsigned short int dest)
+{
+	double *stored = &warmPheremone[dest * numberOfEdges];
+
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+		stored[e] = pheremone[e];
+
+	warmTime[dest] = threads[controllerIndex]->getGlobalTime();
+	warmValid[dest] = true;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	clampPheremone
+// Description:		Keeps the pheremone within [gamma,1] for Max Min ACO
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::clampPheremone()
+{
+	if(threads[controllerIndex]->getCurrentRoutingAlgorithm() != MAX_MIN_ACO)
+		return;
+
+	double gamma = threadZero->getQualityParams().MM_ACO_gamma;
+
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+	{
+		if(pheremone[e] < gamma)
+			pheremone[e] = gamma;
+		else if(pheremone[e] > 1.0)
+			pheremone[e] = 1.0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	evaporatePheremone
+// Description:		Evaporates the pheremone on every edge
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::evaporatePheremone()
+{
+	double rho = threadZero->getQualityParams().ACO_rho;
+
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+		pheremone[e] = (1.0 - rho) * pheremone[e];
+
+	if(threads[controllerIndex]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
+	{
+		double gamma = threadZero->getQualityParams().MM_ACO_gamma;
+
+		for(unsigned int e = 0; e < numberOfEdges; ++e)
+		{
+			if(pheremone[e] < gamma)
+				pheremone[e] = gamma;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addPheremone
+// Description:		Adds the pheremone level based upon the solution quality.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::addPheremone(unsigned int e, unsigned int spans)
+{
+	pheremone[e] = pheremone[e] + 1.0 / double(spans);
+
+	if(threads[controllerIndex]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
+	{
+		if(pheremone[e] > 1.0)
+		{
+			pheremone[e] = 1.0;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateProbabilities
+// Description:		Updates the cumulative probabilities of every
+//					router based upon the current pheremone levels.
+//
+///////////////////////////////////////////////////////////////////
+void AntColony::generateProbabilities()
+{
+	double alpha = threadZero->getQualityParams().ACO_alpha;
+
+	for(unsigned short int n = 0; n < numberOfRouters; ++n)
+	{
+		if(edgeStart[n] == edgeStart[n+1])
+			continue;
+
+		double cumulativeProduct = 0.0;
+
+		for(unsigned int e = edgeStart[n]; e < edgeStart[n+1]; ++e)
+		{
+			probability[e] = pow(pheremone[e],alpha) * heuristic[e];
+			cumulativeProduct += probability[e];
+		}
+
+		for(unsigned int e2 = edgeStart[n]; e2 < edgeStart[n+1]; ++e2)
+		{
+			probability[e2] = probability[e2] / cumulativeProduct;
+
+			if(e2 > edgeStart[n])
+				probability[e2] += probability[e2-1];
+		}
+
+		probability[edgeStart[n+1] - 1] = 1.0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateZeroToOne
+// Description:		Returns a number in [0,1) that only depends on
+//					the seed, the request, the iteration, the ant
+//					and the step, so every ant has its own stream.
+//
+///////////////////////////////////////////////////////////////////
+double AntColony::generateZeroToOne(unsigned int a, unsigned int step)
+{
+	boost::uint64_t x = mixBits(threads[controllerIndex]->getRandomSeed());
+
+	x = mixBits(x ^ requestCounter);
+	x = mixBits(x ^ ((boost::uint64_t(iterationCounter) << 32) | a));
+	x = mixBits(x ^ step);
+
+	return double(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runColonyWorker
+// Description:		Entry point of a helper thread.
+//
+///////////////////////////////////////////////////////////////////
+void *runColonyWorker(void* n)
+{
+	ColonyWorker* cw = static_cast<ColonyWorker*>(n);
+
+	cw->colony->runWorker(cw->index);
+
+	delete cw;
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	mixBits
+// Description:		Scrambles the 64 bits of x (splitmix64 finalizer).
+//
+///////////////////////////////////////////////////////////////////
+static boost::uint64_t mixBits(boost::uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+	return x ^ (x >> 31);
+}
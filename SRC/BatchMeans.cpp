@@ -0,0 +1,149 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      BatchMeans.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the BatchMeans
+//					class. Each batch holds batchSize finished connection
+//					requests. Once minBatches batches are complete, the
+//					confidence interval is calculated after every batch and
+//					the simulation may stop its traffic when the half width
+//					relative to the mean reaches the target precision.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, batch means stopping rule.
+//
+// ____________________________________________________________________________
+
+#include "BatchMeans.h"
+#include "ReplicationStats.h"
+
+#include <limits>
+#include <math.h>
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	BatchMeans
+// Description:		Constructor that takes the number of finished
+//					requests in a batch, the number of batches
+//					needed before stopping and the target relative
+//					half width of the confidence interval.
+//
+///////////////////////////////////////////////////////////////////
+BatchMeans::BatchMeans(unsigned int size, unsigned int minimum, double precision)
+{
+	batchSize = size;
+	minBatches = minimum < 2 ? 2 : minimum;
+	targetPrecision = precision;
+
+	reset(0,0);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~BatchMeans
+// Description:		Default destructor with no arguements.
+//
+///////////////////////////////////////////////////////////////////
+BatchMeans::~BatchMeans()
+{
+	batches.clear();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	reset
+// Description:		Clears the batches and starts the first batch
+//					at the given finished and blocked requests.
+//
+///////////////////////////////////////////////////////////////////
+void BatchMeans::reset(unsigned int finished, unsigned int blocked)
+{
+	lastFinished = finished;
+	lastBlocked = blocked;
+
+	batches.clear();
+
+	mean = 0.0;
+	halfWidth = std::numeric_limits<double>::infinity();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	update
+// Description:		Takes the number of finished and blocked
+//					requests so far. Closes the current batch when
+//					it is full and returns true when the confidence
+//					interval has reached the target precision.
+//
+///////////////////////////////////////////////////////////////////
+bool BatchMeans::update(unsigned int finished, unsigned int blocked)
+{
+	if(finished - lastFinished < batchSize)
+		return false;
+
+	batches.push_back(double(blocked - lastBlocked) / double(finished - lastFinished));
+
+	lastFinished = finished;
+	lastBlocked = blocked;
+
+	if(batches.size() < 2)
+		return false;
+
+	calculateInterval();
+
+	if(batches.size() < minBatches)
+		return false;
+
+	//No blocking seen yet, so there is no relative precision to reach
+	if(mean <= 0.0)
+		return false;
+
+	return halfWidth <= targetPrecision * mean;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getRelativeHalfWidth
+// Description:		Returns the half width of the confidence
+//					interval divided by the mean.
+//
+///////////////////////////////////////////////////////////////////
+double BatchMeans::getRelativeHalfWidth()
+{
+	if(mean <= 0.0)
+		return std::numeric_limits<double>::infinity();
+
+	return halfWidth / mean;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	calculateInterval
+// Description:		Calculates the mean and the 95% half width from
+//					the complete batches.
+//
+///////////////////////////////////////////////////////////////////
+void BatchMeans::calculateInterval()
+{
+	unsigned int n = static_cast<unsigned int>(batches.size());
+
+	double sum = 0.0;
+
+	for(unsigned int b = 0; b < n; ++b)
+		sum += batches[b];
+
+	mean = sum / double(n);
+
+	double squares = 0.0;
+
+	for(unsigned int b = 0; b < n; ++b)
+		squares += (batches[b] - mean) * (batches[b] - mean);
+
+	halfWidth = ReplicationStats::studentT95(n - 1) * sqrt(squares / double(n - 1)) / sqrt(double(n));
+}
@@ -0,0 +1,111 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      CounterRandom.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the CounterRandom
+//					class. The counter of every block is (index, purpose, draw,
+//					extra) and the key is made from the seed and the stream,
+//					which is the workstation or router the numbers belong to.
+//					The rounds follow Salmon et al., "Parallel Random Numbers:
+//					As Easy as 1, 2, 3", SC 2011.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, counter-based random streams.
+//
+// ____________________________________________________________________________
+
+#include "CounterRandom.h"
+
+//Philox4x32 multipliers and Weyl key increments
+static const boost::uint32_t PHILOX_M0 = 0xD2511F53;
+static const boost::uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const boost::uint32_t PHILOX_W0 = 0x9E3779B9;
+static const boost::uint32_t PHILOX_W1 = 0xBB67AE85;
+
+static const unsigned int PHILOX_ROUNDS = 10;
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	makeKey
+// Description:		Combines the seed and the stream into the 64
+//					bit Philox key.
+//
+///////////////////////////////////////////////////////////////////
+boost::uint64_t CounterRandom::makeKey(boost::uint32_t seed, boost::uint32_t stream)
+{
+	return (boost::uint64_t(seed) << 32) | stream;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateBlock
+// Description:		Runs the ten Philox rounds on one counter and
+//					returns the four 32 bit values.
+//
+///////////////////////////////////////////////////////////////////
+void CounterRandom::generateBlock(boost::uint64_t key, boost::uint32_t index, RandomPurpose p,
+	boost::uint32_t draw, boost::uint32_t extra, boost::uint32_t out[RANDOM_BLOCK_SIZE])
+{
+	boost::uint32_t c0 = index;
+	boost::uint32_t c1 = static_cast<boost::uint32_t>(p);
+	boost::uint32_t c2 = draw;
+	boost::uint32_t c3 = extra;
+
+	boost::uint32_t k0 = static_cast<boost::uint32_t>(key);
+	boost::uint32_t k1 = static_cast<boost::uint32_t>(key >> 32);
+
+	for(unsigned int r = 0; r < PHILOX_ROUNDS; ++r)
+	{
+		boost::uint64_t p0 = boost::uint64_t(PHILOX_M0) * c0;
+		boost::uint64_t p1 = boost::uint64_t(PHILOX_M1) * c2;
+
+		boost::uint32_t n0 = static_cast<boost::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+		boost::uint32_t n1 = static_cast<boost::uint32_t>(p1);
+		boost::uint32_t n2 = static_cast<boost::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+		boost::uint32_t n3 = static_cast<boost::uint32_t>(p0);
+
+		c0 = n0;
+		c1 = n1;
+		c2 = n2;
+		c3 = n3;
+
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateZeroToOne
+// Description:		Fills out with n numbers in (0,1), starting at
+//					the number first of the stream. Every block
+//					only depends on its own counter, so a batch
+//					costs one Philox call per four numbers.
+//
+///////////////////////////////////////////////////////////////////
+void CounterRandom::generateZeroToOne(boost::uint64_t key, boost::uint32_t index, RandomPurpose p,
+	boost::uint32_t first, unsigned int n, double* out)
+{
+	boost::uint32_t block[RANDOM_BLOCK_SIZE];
+
+	for(unsigned int i = 0; i < n; ++i)
+	{
+		boost::uint32_t d = first + i;
+
+		if(i == 0 || d % RANDOM_BLOCK_SIZE == 0)
+			generateBlock(key,index,p,d / RANDOM_BLOCK_SIZE,0,block);
+
+		out[i] = toZeroToOne(block[d % RANDOM_BLOCK_SIZE]);
+	}
+}
@@ -21,6 +21,8 @@
 #include "Edge.h"
 #include "Thread.h"
 
+#include <limits>
+
 #ifdef RUN_GUI
 
 #include <stdlib.h>
@@ -64,19 +66,20 @@ Edge::Edge()
 //
 // Function Name:	Edge
 // Description:		Constructor with arguements to set the source,
-//					destination, and number of spans.
+//					destination, number of spans, and index.
 //
 ///////////////////////////////////////////////////////////////////
-Edge::Edge(unsigned short int src, unsigned short int dest, unsigned short int spans)
+Edge::Edge(unsigned short int src, unsigned short int dest, unsigned short int spans, unsigned short int i)
 {
 	sourceIndex = src;
 	destinationIndex = dest;
 	numberOfSpans = spans;
 
-	status = new EdgeStatus[threadZero->getNumberOfWavelengths()];
-	activeSession = new int[threadZero->getNumberOfWavelengths()];
+	index = i;
+	linkState = 0;
 
 	degredation = new double[threadZero->getNumberOfWavelengths()];
+	QMPending = new bool[threadZero->getNumberOfWavelengths()];
 
 	resetQMDegredation();
 
@@ -84,16 +87,12 @@ Edge::Edge(unsigned short int src, unsigned short int dest, unsigned short int s
 
 	resetEdgeStats();
 
-	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
-	{
-		status[w] = EDGE_FREE;
-		activeSession[w] = -1;
-	}
-
 	algorithmUsage = 0.0;
 	actualUsage = 0;
 	QMDegredation = 0.0;
 
+	version = 0;
+
 #ifdef RUN_GUI
 	max_actual_usage = 0;
 
@@ -113,10 +112,8 @@ Edge::Edge(unsigned short int src, unsigned short int dest, unsigned short int s
 ///////////////////////////////////////////////////////////////////
 Edge::~Edge()
 {
-	delete[] status;
-	delete[] activeSession;
-
 	delete[] degredation;
+	delete[] QMPending;
 
 	delete[] stats;
 
@@ -130,63 +127,6 @@ Edge::~Edge()
 #endif
 }
 
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	evaporatePheremone
-// Description:		Evaporates the pheremone
-//
-///////////////////////////////////////////////////////////////////
-void Edge::evaporatePheremone(unsigned int ci)
-{
-	pheremone = (1.0 - threadZero->getQualityParams().ACO_rho) * pheremone;
-
-	if(threads[ci]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
-	{
-		if(pheremone < threadZero->getQualityParams().MM_ACO_gamma)
-		{
-			pheremone = threadZero->getQualityParams().MM_ACO_gamma;
-		}
-	}
-}
-
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	resetPheremone
-// Description:		Resets the pheremone levels to the initial value
-//
-///////////////////////////////////////////////////////////////////
-void Edge::resetPheremone(unsigned int ci, unsigned int spans)
-{
-	if(threads[ci]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
-	{
-		pheremone = 1.0;
-	}
-	else if(threads[ci]->getCurrentRoutingAlgorithm() == ACO)
-	{
-		pheremone = double(threadZero->getQualityParams().ACO_ants) /
-			double(spans);
-	}
-}
-
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	addPheremone
-// Description:		Adds the pheremone level based upon the solution quality.
-//
-///////////////////////////////////////////////////////////////////
-void Edge::addPheremone(unsigned int hops, unsigned int ci)
-{
-	pheremone = pheremone + 1.0 / float(hops);
-
-	if(threads[ci]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
-	{
-		if(pheremone > 1.0)
-		{
-			pheremone = 1.0;
-		}
-	}
-}
-
 #ifdef RUN_GUI
 ///////////////////////////////////////////////////////////////////
 //
@@ -336,6 +276,22 @@ void Edge::scaleEdgesTo(int spns, int px)
 	numberOfSpans = newspans;
 }
 #endif
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	setLinkState
+// Description:		Sets the row of the link state of the thread that
+//					holds the wavelengths of this edge, and marks all
+//					of them as free.
+//
+///////////////////////////////////////////////////////////////////
+void Edge::setLinkState(int *s)
+{
+	linkState = s;
+
+	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
+		linkState[w] = LINK_STATE_FREE;
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	updateUsage
@@ -354,29 +310,35 @@ void Edge::updateUsage()
 	{
 		for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 		{
-			if(status[w] == EDGE_USED)
+			if(linkState[w] != LINK_STATE_FREE)
 				++newUsage;
 		}
 	}
 
 	algorithmUsage = (algorithmUsage + newUsage) / float(2.0);
+
+	++version;
 }
 
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	updateQMDegredation
-// Description:		Updates the usage of the edges
+// Description:		Marks the degredation of the lightpaths near the
+//					wavelength as out of date. The degredation is
+//					recalculated once the edge cost is read by
+//					getQMDegredation.
 //
 ///////////////////////////////////////////////////////////////////
-void Edge::updateQMDegredation(unsigned short int ci, unsigned int wavelength)
+void Edge::updateQMDegredation(SimulationContext* ctx, unsigned int wavelength)
 {	
-	ResourceManager* rm = threadZero->getResourceManager();
+	ResourceManager* rm = ctx->getResourceManager();
+	const PhysicalParameters& pp = ctx->getPhysicalParams();
 
 #ifdef RUN_GUI
-	thdIndx = ci; //TODO: put this in a location where it isn't repeated.
+	thdIndx = ctx->getControllerIndex(); //TODO: put this in a location where it isn't repeated.
 #endif
 
-	double time = threads[ci]->getGlobalTime();
+	double time = ctx->getThread()->getGlobalTime();
 
 	for(list<void*>::iterator iter = establishedConnections.begin();
 		iter != establishedConnections.end(); ++iter)
@@ -386,55 +348,98 @@ void Edge::updateQMDegredation(unsigned short int ci, unsigned int wavelength)
 		for(unsigned short int p = 0; p < ec->connectionLength; ++p)
 		{
 			if(ec->connectionPath[p] == this &&
-				abs(ec->wavelength - int(wavelength)) <= threadZero->getQualityParams().nonlinear_halfwin)
+				abs(ec->wavelength - int(wavelength)) <= pp.nonlinear_halfwin)
 			{
-				double xpm = 0.0;
-				double fwm = 0.0;
-				double ase = 0.0;
-			
-				double source_noise = 0.0;
-				double source_Q = 0.0;
+				++ctx->getThread()->getGlobalStats().qmRequested;
+
+				QMPending[ec->wavelength] = true;
+				QMDirty = true;
+
+				//The Q-factor stats are sampled now, at the time of the change.
+				if(ctx->getQualityParams().q_factor_stats == true && 
+					p == ec->connectionLength - 1)
+				{
+					rm->update_lightpath_noise(ec,ctx);
+
+					double dest_Q = 10.0 * log10(pp.channel_power /
+						sqrt(rm->lightpath_noise(ec,p+1)));
+
+					if(ec->QFactors->size() == 0)
+						ec->initQFactor = float(dest_Q);
+
+					ec->QFactors->push_back(float(dest_Q));
+					ec->QTimes->push_back(time);
+
+					if(ec->variantQFactors != 0)
+						sampleQVariants(ctx,ec);
+				}
+
+				break;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getQMDegredation
+// Description:		Returns the cost of the edge for the QM
+//					algorithm, recalculating the degredation of the
+//					lightpaths marked by updateQMDegredation first.
+//
+///////////////////////////////////////////////////////////////////
+float Edge::getQMDegredation(SimulationContext* ctx)
+{
+	if(QMDirty == false)
+		return QMDegredation;
+
+	ResourceManager* rm = ctx->getResourceManager();
+	const PhysicalParameters& pp = ctx->getPhysicalParams();
+
+	for(list<void*>::iterator iter = establishedConnections.begin();
+		iter != establishedConnections.end(); ++iter)
+	{
+		EstablishedConnection* ec = static_cast<EstablishedConnection*>(*iter);
 
+		if(QMPending[ec->wavelength] == false)
+			continue;
+
+		for(unsigned short int p = 0; p < ec->connectionLength; ++p)
+		{
+			if(ec->connectionPath[p] == this)
+			{
+				double source_noise = 0.0;
 				double dest_noise = 0.0;
-				double dest_Q = 0.0;
+
+				//Only the wavelengths that changed on the path are recalculated.
+				rm->update_lightpath_noise(ec,ctx);
 			
 				if(p == 0)
 				{
-					source_noise = threadZero->getQualityParams().ASE_perEDFA[threadZero->getQualityParams().halfwavelength];
+					source_noise = pp.ASE_perEDFA[pp.halfwavelength];
 				}
 				else
 				{
-					source_Q = rm->estimate_Q(ec->wavelength,ec->connectionPath,p,&xpm,&fwm,&ase,ci);
-
-					source_noise = pow(threadZero->getQualityParams().channel_power / pow(10.0,source_Q/10.0),2.0);
+					source_noise = rm->lightpath_noise(ec,p);
 				}
 			
-				dest_Q = rm->estimate_Q(ec->wavelength,ec->connectionPath,p+1,&xpm,&fwm,&ase,ci);
-
-				dest_noise = pow(threadZero->getQualityParams().channel_power / pow(10.0,dest_Q/10.0),2.0);
+				dest_noise = rm->lightpath_noise(ec,p+1);
 			
 				degredation[ec->wavelength] = 10.0 * log10(sqrt(dest_noise) / sqrt(source_noise));
 
-
-				if(threadZero->getQualityParams().q_factor_stats == true && 
-					p == ec->connectionLength - 1)
-				{
-					if(ec->QFactors->size() == 0)
-						ec->initQFactor = float(dest_Q);
-
-					ec->QFactors->push_back(float(dest_Q));
-					ec->QTimes->push_back(time);
-				}
+				++ctx->getThread()->getGlobalStats().qmRecalculated;
 
 				break;
 			}
 		}
+
+		QMPending[ec->wavelength] = false;
 	}
 
 	unsigned short int activeLightpaths = 0;
 	double cumulativeDegradation = 0.0;
 
-	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
+	for(unsigned short int w = 0; w < ctx->getNumberOfWavelengths(); ++w)
 	{
 		if(degredation[w] != 0.0)
 		{
@@ -443,12 +448,16 @@ void Edge::updateQMDegredation(unsigned short int ci, unsigned int wavelength)
 		}
 	}
 
-	if(activeLightpaths == threadZero->getNumberOfWavelengths())
+	if(activeLightpaths == ctx->getNumberOfWavelengths())
 		QMDegredation = std::numeric_limits<float>::infinity();
 	else if(activeLightpaths == 0)
 		QMDegredation = 2.0;
 	else if(activeLightpaths > 0)
 		QMDegredation = float(cumulativeDegradation) / float(activeLightpaths);
+
+	QMDirty = false;
+
+	return QMDegredation;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -457,53 +466,58 @@ void Edge::updateQMDegredation(unsigned short int ci, unsigned int wavelength)
 // Description:		Updates the Q Factor stats
 //
 ///////////////////////////////////////////////////////////////////
-void Edge::updateQFactorStats(unsigned short int ci, unsigned int wavelength)
+void Edge::updateQFactorStats(SimulationContext* ctx, unsigned int wavelength)
 {
-	ResourceManager* rm = threadZero->getResourceManager();
+	ResourceManager* rm = ctx->getResourceManager();
+	const PhysicalParameters& pp = ctx->getPhysicalParams();
 
 #ifdef RUN_GUI
-	thdIndx = ci; //TODO: put this in a location where it isn't repeated.
+	thdIndx = ctx->getControllerIndex(); //TODO: put this in a location where it isn't repeated.
 #endif
 
-	double time = threads[ci]->getGlobalTime();
+	double time = ctx->getThread()->getGlobalTime();
 
 	for(list<void*>::iterator iter = establishedConnections.begin();
 		iter != establishedConnections.end(); ++iter)
 	{
 		EstablishedConnection* ec = static_cast<EstablishedConnection*>(*iter);
 
-		if(abs(ec->wavelength - int(wavelength)) <= threadZero->getQualityParams().nonlinear_halfwin)
+		if(abs(ec->wavelength - int(wavelength)) <= pp.nonlinear_halfwin &&
+		   (ec->QTimes->size() == 0 || ec->QTimes->back() != time))
 		{
-			if(ec->QTimes->size() == 0)
-			{
-				double xpm = 0.0;
-				double fwm = 0.0;
-				double ase = 0.0;
+			rm->update_lightpath_noise(ec,ctx);
 
-				ec->QFactors->push_back(float(rm->estimate_Q(
-					ec->wavelength,ec->connectionPath,
-					ec->connectionLength,&xpm,&fwm,&ase,ci)));
+			ec->QFactors->push_back(float(10.0 * log10(pp.channel_power /
+				sqrt(rm->lightpath_noise(ec,ec->connectionLength)))));
 
-				ec->QTimes->push_back(time);
+			ec->QTimes->push_back(time);
 
+			if(ec->QTimes->size() == 1)
 				ec->initQFactor = float(ec->QFactors->at(0));
-			}
-			else if(ec->QTimes->back() != time)
-			{
-				double xpm = 0.0;
-				double fwm = 0.0;
-				double ase = 0.0;
-
-				ec->QFactors->push_back(float(rm->estimate_Q(
-					ec->wavelength,ec->connectionPath,
-					ec->connectionLength,&xpm,&fwm,&ase,ci)));
 
-				ec->QTimes->push_back(time);
-			}
+			if(ec->variantQFactors != 0)
+				sampleQVariants(ctx,ec);
 		}
 	}
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	sampleQVariants
+// Description:		Adds the Q-factor of every physical parameter
+//					variant of a connection, at the time of its
+//					latest Q-factor sample.
+//
+///////////////////////////////////////////////////////////////////
+void Edge::sampleQVariants(SimulationContext* ctx, EstablishedConnection* ec)
+{
+	float Q[MAX_Q_VARIANTS];
+
+	ctx->getResourceManager()->lightpath_Q_variants(ec,Q);
+
+	ec->variantQFactors->insert(ec->variantQFactors->end(),Q,Q + ctx->getPhysicalParams().variants);
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	resetQMDegredation
@@ -513,7 +527,14 @@ void Edge::updateQFactorStats(unsigned short int ci, unsigned int wavelength)
 void Edge::resetQMDegredation()
 {
 	for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
+	{
 		degredation[w] = 0.0;
+		QMPending[w] = false;
+	}
+
+	//Same cost as a new edge, so the cost does not depend on the previous simulation
+	QMDegredation = 0.0;
+	QMDirty = false;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -522,7 +543,7 @@ void Edge::resetQMDegredation()
 // Description:		Removes an established connection
 //
 ///////////////////////////////////////////////////////////////////
-void Edge::removeEstablishedConnection(void* dcpe_void)
+void Edge::removeEstablishedConnection(SimulationContext* ctx, void* dcpe_void)
 {
 	DestroyConnectionProbeEvent* dcpe = static_cast<DestroyConnectionProbeEvent*>(dcpe_void);
 	EstablishedConnection* ec;
@@ -540,6 +561,8 @@ void Edge::removeEstablishedConnection(void* dcpe_void)
 	}
 
 	degredation[dcpe->wavelength] = 0.0;
+	QMPending[dcpe->wavelength] = false;
+	QMDirty = true;
 
 	if(this != dcpe->connectionPath[dcpe->connectionLength - 1])
 		return;
@@ -574,6 +597,7 @@ void Edge::removeEstablishedConnection(void* dcpe_void)
 		if(connectionDropped == true)
 		{
 			++stats->droppedConnections;
+			++ctx->getThread()->getGlobalStats().DroppedFailures;
 		}
 
 		weight += ec->QFactors->at(s) * 
@@ -588,6 +612,9 @@ void Edge::removeEstablishedConnection(void* dcpe_void)
 
 		ec->belowQFactor = float(timebelow / (ec->connectionEndTime - ec->connectionStartTime));
 
+		if(ec->variantQFactors != 0)
+			addVariantStats(ctx,ec);
+
 #ifdef RUN_GUI
 		int src = dcpe->connectionPath[0]->getSourceIndex();
 		threads[thdIndx]->getRouterAt(src)->addToAvgQFrom( ec->averageQFactor );
@@ -622,11 +649,34 @@ void Edge::removeEstablishedConnection(void* dcpe_void)
 
 		delete ec->QFactors;
 		delete ec->QTimes;
+		delete ec->variantQFactors;
 	}
 
+	threadZero->getResourceManager()->free_lightpath_noise(ec);
+
 	delete ec;
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	markEstablishedConnections
+// Description:		Marks wavelength w as changed for the established
+//					connections on this edge, so their noise is
+//					recalculated for that wavelength only.
+//
+///////////////////////////////////////////////////////////////////
+void Edge::markEstablishedConnections(unsigned short int w)
+{
+	for(list<void*>::iterator iter = establishedConnections.begin();
+		iter != establishedConnections.end(); ++iter)
+	{
+		EstablishedConnection* ec = static_cast<EstablishedConnection*>(*iter);
+
+		ec->dirtyWaves[w] = true;
+		ec->dirty = true;
+	}
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	resetQMDegredation
@@ -647,6 +697,76 @@ void Edge::resetEdgeStats()
 	stats->totalTime = 0.0;
 	stats->count = 0;
 	stats->droppedConnections = 0;
+
+	for(unsigned short int v = 0; v < MAX_Q_VARIANTS; ++v)
+	{
+		stats->variantDroppedConnections[v] = 0;
+		stats->variantInitalQFactor[v] = 0.0;
+		stats->variantAverageQFactor[v] = 0.0;
+		stats->variantPercentQFactor[v] = 0.0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addVariantStats
+// Description:		Adds the Q-factors of every physical parameter
+//					variant of a finished connection to the stats,
+//					in the same way as the Q-factors of the
+//					simulation.
+//
+///////////////////////////////////////////////////////////////////
+void Edge::addVariantStats(SimulationContext* ctx, EstablishedConnection* ec)
+{
+	const PhysicalParameters& pp = threadZero->getResourceManager()->getPhysicalParams();
+
+	double weight[MAX_Q_VARIANTS];
+	double timebelow[MAX_Q_VARIANTS];
+	bool connectionDropped[MAX_Q_VARIANTS];
+
+	for(unsigned short int v = 0; v < pp.variants; ++v)
+	{
+		weight[v] = 0.0;
+		timebelow[v] = 0.0;
+		connectionDropped[v] = false;
+	}
+
+	unsigned int samples = static_cast<unsigned int>(ec->QTimes->size());
+
+	for(unsigned int s = 0; s < samples; ++s)
+	{
+		double end = s + 1 < samples ? ec->QTimes->at(s+1) : ec->connectionEndTime;
+		double length = end - ec->QTimes->at(s);
+
+		const float* Q = &ec->variantQFactors->at(s * pp.variants);
+
+		for(unsigned short int v = 0; v < pp.variants; ++v)
+		{
+			weight[v] += Q[v] * length;
+
+			if(Q[v] < pp.variant_TH_Q[v])
+			{
+				timebelow[v] += length;
+
+				//As for the simulation, only a Q-factor that was replaced counts as dropped
+				if(s + 1 < samples)
+					connectionDropped[v] = true;
+			}
+		}
+	}
+
+	for(unsigned short int v = 0; v < pp.variants; ++v)
+	{
+		if(connectionDropped[v] == true)
+		{
+			++stats->variantDroppedConnections[v];
+			++ctx->getThread()->getGlobalStats().variantDroppedFailures[v];
+		}
+
+		stats->variantInitalQFactor[v] += ec->variantQFactors->at(v);
+		stats->variantAverageQFactor[v] += weight[v] / (ec->connectionEndTime - ec->connectionStartTime);
+		stats->variantPercentQFactor[v] += timebelow[v];
+	}
 }
 
 #ifdef RUN_GUI
@@ -668,7 +788,7 @@ void Edge::updateGUI()
 
 		for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 		{
-			if(status[w] == EDGE_USED)
+			if(linkState[w] != LINK_STATE_FREE)
 				++actualUsage;
 		}
 	}
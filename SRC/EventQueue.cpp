@@ -56,3 +56,22 @@ Event EventQueue::getNextEvent()
 
 	return retVal;
 }
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	copyEvents
+// Description:		Adds a copy of all of the events in the priority
+//					queue to the vector, in the order they are run.
+//					The queue itself is left unchanged.
+//
+///////////////////////////////////////////////////////////////////
+void EventQueue::copyEvents(vector<Event> &events)
+{
+	priority_queue<Event, vector<Event>,less<vector<Event>::value_type> > copy(pq);
+
+	while(copy.empty() == false)
+	{
+		events.push_back(copy.top());
+		copy.pop();
+	}
+}
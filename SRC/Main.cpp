@@ -22,6 +22,7 @@
 #include "nonlinear.h"
 #include "pthread.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -75,13 +76,37 @@ Thread* threadZero;
 Thread** threads;
 unsigned short int threadCount;
 
+//The topology is read once and shared by all of the threads and runs
+NetworkTopology* network;
+
 vector<AlgorithmToRun*> algParams;
 
 void *runThread(void* n);
 void runSimulation(int argc, const char* argv[]);
 
+double estimateAlgorithmCost(const AlgorithmToRun* alg);
+bool cheaperAlgorithm(const AlgorithmToRun* a, const AlgorithmToRun* b);
+
 pthread_mutex_t ScheduleMutex;
 
+//Time each thread spent running simulations, and how many it ran.
+vector<double> workerBusyTime;
+vector<unsigned int> workerJobs;
+
+//Relative cost of one connection request for each routing algorithm, in the
+//order of the RoutingAlgorithm enum. Only the order of the jobs depends on it.
+const double RoutingAlgorithmCost[NUMBER_OF_ROUTING_ALGORITHMS] = {
+	1.0,	//SHORTEST_PATH
+	4.0,	//PABR
+	2.0,	//LORA
+	2.0,	//IMPAIRMENT_AWARE, per wavelength
+	4.0,	//Q_MEASUREMENT
+	6.0,	//ADAPTIVE_QoS
+	10.0,	//DYNAMIC_PROGRAMMING
+	25.0,	//ACO
+	60.0	//MAX_MIN_ACO
+};
+
 int main( int argc, const char* argv[] )
 {
 	if(argc != 7)
@@ -169,48 +194,71 @@ void runSimulation(int argc, const char* argv[])
 	int* threadZeroReturn = 0;
 	int runCount = 0;
 
-	while(threadZeroReturn == 0 || *threadZeroReturn == MORE_SIMULATIONS)
-	{
-		delete threadZeroReturn;
-
-		vector<pthread_t*> pThreads;
-
-		threadCount = atoi(argv[4]);
+	threadCount = atoi(argv[4]);
 
-		threads = new Thread*[threadCount];
-
-		unsigned short int iterationCount = atoi(argv[5]);
+	threads = new Thread*[threadCount];
 
 #ifdef RUN_GUI
 	rectfill(screen, 0, 0, SCREEN_W, 40, color);
 	textprintf_ex(screen,font,20,15,color2,color,"Building XPM Database, please wait..."); 
 #endif
 
-		Thread* thread = new Thread(0,argc,argv,false,runCount);
+	//The threads and the Resource Manager are built once and kept for
+	//every set of quality parameters in the file.
+	Thread* thread = new Thread(0,argc,argv,false,runCount);
 
-		threadZero->initResourceManager();
+	threadZero->initResourceManager();
 
 #ifdef RUN_GUI
-		rectfill(screen, 0, 0, SCREEN_W, 40, color);
+	rectfill(screen, 0, 0, SCREEN_W, 40, color);
 #endif
 
-		pthread_mutex_init(&ScheduleMutex,NULL);
+	if(threadCount > algParams.size())
+		threadCount = static_cast<unsigned short int>(algParams.size());
+
+	for(unsigned short int t = 1; t < threadCount; ++t)
+	{
+		Thread* thread = new Thread(t,argc,argv,false,runCount);
+
+		thread->initResourceManager();
+	}
 
-		if(threadCount > algParams.size())
-			threadCount = static_cast<unsigned short int>(algParams.size());
+	pthread_mutex_init(&ScheduleMutex,NULL);
+
+	while(threadZeroReturn == 0 || *threadZeroReturn == MORE_SIMULATIONS)
+	{
+		if(threadZeroReturn != 0)
+		{
+			++runCount;
+
+			threadZero->loadParameterSet(argc,argv,runCount);
+
+			for(unsigned short int t = 1; t < threadCount; ++t)
+				threads[t]->resetParameterSet();
+		}
+
+		delete threadZeroReturn;
+
+		vector<pthread_t*> pThreads;
+
+		//The threads take the jobs from the back, so the most expensive
+		//simulations are started first and the cheap ones fill the gaps.
+		std::stable_sort(algParams.begin(),algParams.end(),cheaperAlgorithm);
+
+		workerBusyTime.assign(threadCount,0.0);
+		workerJobs.assign(threadCount,0);
 
 		for(unsigned short int t = 1; t < threadCount; ++t)
 		{
-			Thread* thread = new Thread(t,argc,argv,false,runCount);
 			pThreads.push_back(new pthread_t);
-
-			thread->initResourceManager();
 		}
 
 		char buffer[25];
 		sprintf(buffer,"Created %d threads.\n",threadCount);
 		threadZero->recordEvent(buffer,true,0);
 
+		double scheduleStart = getWallClock();
+
 		for(unsigned short int t = 1; t < threadCount; ++t)
 		{
 			pthread_create(pThreads[t-1],NULL,runThread,new unsigned short int(t));
@@ -227,24 +275,35 @@ void runSimulation(int argc, const char* argv[])
 #endif
 		}
 
+		double scheduleTime = getWallClock() - scheduleStart;
+
 		for(unsigned short int t = 0; t < threadCount; ++t)
 		{
-			delete threads[t];
-
-			if(t != 0)
-				delete pThreads[t-1];
+			char utilBuffer[200];
+			sprintf(utilBuffer,"THREAD %d: JOBS = %d, BUSY (%f/%f) = %f", t, workerJobs[t],
+				workerBusyTime[t], scheduleTime, workerBusyTime[t] / scheduleTime);
+			threadZero->recordEvent(utilBuffer,true,0);
 		}
 
-		delete[] threads;
+		for(unsigned short int t = 1; t < threadCount; ++t)
+		{
+			delete pThreads[t-1];
+		}
 
 		pThreads.clear();
+	}
 
-		pthread_mutex_destroy(&ScheduleMutex);
-
-		++runCount;
+	for(unsigned short int t = threadCount; t > 0; --t)
+	{
+		delete threads[t-1];
 	}
 
+	delete[] threads;
+
+	pthread_mutex_destroy(&ScheduleMutex);
+
 	delete threadZeroReturn;
+	delete network;
 
 	nonlinearTerminate();
 	mclTerminateApplication();
@@ -266,17 +325,30 @@ void *runThread(void* n)
 
 	int *retVal = new int;
 
-	while(algParams.size() > 0)
+	*retVal = threads[*t_id]->getRunStatus();
+
+	while(true)
 	{
 		pthread_mutex_lock(&ScheduleMutex);
 
+		if(algParams.size() == 0)
+		{
+			pthread_mutex_unlock(&ScheduleMutex);
+			break;
+		}
+
 		AlgorithmToRun* alg = algParams.back();
 		algParams.pop_back();
 
 		pthread_mutex_unlock(&ScheduleMutex);
 
+		double jobStart = getWallClock();
+
 		*retVal = threads[*t_id]->runThread(alg);
 
+		workerBusyTime[*t_id] += getWallClock() - jobStart;
+		++workerJobs[*t_id];
+
 #ifdef RUN_GUI
 		textprintf_ex(screen,font,20,SCREEN_H-30,color2,color,"%s",folder); 
 		threads[*t_id]->saveThread(folder);
@@ -287,3 +359,50 @@ void *runThread(void* n)
 
 	return retVal;
 }
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	estimateAlgorithmCost
+// Description:		Estimates the relative run time of a simulation
+//					from its routing algorithm, workstations,
+//					wavelengths and probe style.
+//
+///////////////////////////////////////////////////////////////////
+double estimateAlgorithmCost(const AlgorithmToRun* alg)
+{
+	//The workstations of a load ramp grow by the same number every stage
+	double cost = RoutingAlgorithmCost[alg->ra] * double(alg->workstations) * double(alg->stages + 1) / 2.0 *
+		double(threadZero->getNumberOfWavelengths());
+
+	if(alg->ra == IMPAIRMENT_AWARE)
+		cost *= double(threadZero->getNumberOfWavelengths());
+
+	if(alg->ps != SINGLE)
+		cost *= 2.0;
+
+	//The algorithms forked from the warm state are run by the same job
+	if(alg->warmFork == true)
+	{
+		for(unsigned short int a = 0; a < threadZero->getForkAlgorithms().size(); ++a)
+		{
+			AlgorithmToRun fork = *threadZero->getForkAlgorithms()[a];
+			fork.workstations = alg->workstations;
+
+			cost += estimateAlgorithmCost(&fork);
+		}
+	}
+
+	return cost;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	cheaperAlgorithm
+// Description:		Orders the simulations from the cheapest to the
+//					most expensive.
+//
+///////////////////////////////////////////////////////////////////
+bool cheaperAlgorithm(const AlgorithmToRun* a, const AlgorithmToRun* b)
+{
+	return estimateAlgorithmCost(a) < estimateAlgorithmCost(b);
+}
@@ -19,10 +19,17 @@
 #include "MessageLogger.h"
 #include "Thread.h"
 
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
 extern Thread* threadZero;
 extern Thread** threads;
 
@@ -249,3 +256,29 @@ char* itoa( int value, char* result, int base )
 	
 	return result;
 }
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getWallClock
+// Description:		Returns the wall clock time in seconds with
+//					sub-second resolution.
+//
+///////////////////////////////////////////////////////////////////
+double getWallClock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv,0);
+
+	return double(tv.tv_sec) + double(tv.tv_usec) * 1.0e-6;
+#endif
+}
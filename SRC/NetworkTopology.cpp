@@ -0,0 +1,425 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      NetworkTopology.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the NetworkTopology
+//					class. The NetworkTopology holds the routers, edges,
+//					workstations and traffic demand read from the input files.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, topology shared by all threads.
+//
+// ____________________________________________________________________________
+
+#include "ErrorCodes.h"
+#include "NetworkTopology.h"
+#include "Thread.h"
+
+#include <string.h>
+
+extern Thread* threadZero;
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	NetworkTopology
+// Description:		Reads the topology, workstation and traffic files
+//					of the topology and number of wavelengths.
+//
+///////////////////////////////////////////////////////////////////
+NetworkTopology::NetworkTopology(const char* topology, const char* wavelengths)
+{
+	char fileName[200];
+
+	demand = 0;
+	aliasProbability = 0;
+	aliasIndex = 0;
+
+	sprintf(fileName,"INPUT/Topology-%s.txt",topology);
+	readTopology(fileName);
+
+	sprintf(fileName,"INPUT/Workstation-%s-%s.txt",topology,wavelengths);
+	readWorkstations(fileName);
+
+	if(threadZero->getQualityParams().dest_dist == TRAFFIC_MATRIX)
+	{
+		sprintf(fileName,"INPUT/Traffic-%s.txt",topology);
+		readTraffic(fileName);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~NetworkTopology
+// Description:		Deletes the traffic demand and alias tables.
+//
+///////////////////////////////////////////////////////////////////
+NetworkTopology::~NetworkTopology()
+{
+	delete[] demand;
+	delete[] aliasProbability;
+	delete[] aliasIndex;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	readTopology
+// Description:		Reads the routers and the links between them,
+//					every link is kept as an edge in each direction.
+//
+///////////////////////////////////////////////////////////////////
+void NetworkTopology::readTopology(const char* f)
+{
+	char buffer[200];
+	sprintf(buffer,"Reading Topology Parameters from %s file.",f);
+	threadZero->recordEvent(buffer,false,0);
+
+	ifstream inFile(f);
+
+	char *param;
+
+	numberOfRouters = 0;
+
+	while(inFile.getline(buffer,199))
+	{
+		param = strtok(buffer,"=");
+
+		if(strcmp(param,"Router") == 0)
+		{
+#ifdef RUN_GUI
+			routerXPercent.push_back(atoi(strtok(NULL,",")));
+			routerYPercent.push_back(atoi(strtok(NULL,",")));
+#endif
+			++numberOfRouters;
+		}
+		else if(strcmp(param,"Edge") == 0)
+		{
+			unsigned short int from = atoi(strtok(NULL,","));
+			unsigned short int to = atoi(strtok(NULL,","));
+			unsigned short int spans = atoi(strtok(NULL,","));
+
+			edgeSource.push_back(from);
+			edgeDestination.push_back(to);
+			edgeSpans.push_back(spans);
+
+			edgeSource.push_back(to);
+			edgeDestination.push_back(from);
+			edgeSpans.push_back(spans);
+		}
+		else
+		{
+			threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
+			inFile.close();
+			exit(ERROR_TOPOLOGY_INPUT_EDGES);
+		}
+	}
+
+	sprintf(buffer,"\tCreated %d routers.",numberOfRouters);
+	threadZero->recordEvent(buffer,false,0);
+
+	sprintf(buffer,"\tCreated %d edges.",getNumberOfEdges());
+	threadZero->recordEvent(buffer,false,0);
+
+	inFile.close();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	readWorkstations
+// Description:		Reads the router every workstation is attached
+//					to. The workstations that are not listed are
+//					spread evenly over the routers.
+//
+///////////////////////////////////////////////////////////////////
+void NetworkTopology::readWorkstations(const char* f)
+{
+	char buffer[200];
+	sprintf(buffer,"Reading Workstation Parameters from %s file.",f);
+	threadZero->recordEvent(buffer,false,0);
+
+	ifstream inFile(f);
+
+	inFile.getline(buffer,199);
+
+	char *param;
+	char *parent;
+
+	param = strtok(buffer,"=");
+	parent = strtok(NULL," ,\t");
+
+	if(strcmp(param,"NumberOfWorkstations") == 0)
+		numberOfWorkstations = atoi(parent);
+	else
+	{
+		threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
+		exit(ERROR_WORKSTATION_INPUT_QUANTITY);
+	}
+
+	//Add the specific configuration of workstations, if specified.
+	while(inFile.getline(buffer,199))
+	{
+		param = strtok(buffer,"=");
+		parent = strtok(NULL," ,\t");
+
+		if(strcmp(param,"Workstation") == 0)
+		{
+			workstationParent.push_back(atoi(parent));
+		}
+		else
+		{
+			threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
+			inFile.close();
+			exit(ERROR_WORKSTATION_INPUT_PARENT);
+		}
+	}
+
+	//If workstations are not specified, then just uniformly distribute them amongst the routers.
+	for(unsigned short int n = static_cast<unsigned short int>(workstationParent.size()); n < numberOfWorkstations; ++n)
+	{
+		workstationParent.push_back(n % numberOfRouters);
+	}
+
+	inFile.close();
+
+	sprintf(buffer,"\tCreated %d workstations.",numberOfWorkstations);
+	threadZero->recordEvent(buffer,false,0);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	readTraffic
+// Description:		Reads the demand between the routers used by the
+//					TRAFFIC_MATRIX distribution of the destinations.
+//
+///////////////////////////////////////////////////////////////////
+void NetworkTopology::readTraffic(const char* f)
+{
+	char buffer[200];
+	sprintf(buffer,"Reading Traffic Parameters from %s file.",f);
+	threadZero->recordEvent(buffer,false,0);
+
+	ifstream inFile(f);
+
+	if(!inFile)
+	{
+		sprintf(buffer,"ERROR: Unable to open the %s file!!!",f);
+		threadZero->recordEvent(buffer,true,0);
+		exit(ERROR_TRAFFIC_INPUT);
+	}
+
+	demand = new double[numberOfRouters * numberOfRouters];
+
+	for(unsigned int d = 0; d < static_cast<unsigned int>(numberOfRouters * numberOfRouters); ++d)
+		demand[d] = 0.0;
+
+	char *param;
+
+	unsigned int numberOfDemands = 0;
+
+	while(inFile.getline(buffer,199))
+	{
+		param = strtok(buffer,"=");
+
+		if(param != 0 && strcmp(param,"Demand") == 0)
+		{
+			unsigned short int from = atoi(strtok(NULL,","));
+			unsigned short int to = atoi(strtok(NULL,","));
+			double d = atof(strtok(NULL,","));
+
+			if(from >= numberOfRouters || to >= numberOfRouters || from == to || d < 0.0)
+			{
+				threadZero->recordEvent("ERROR: Invalid demand in the input file!!!",true,0);
+				inFile.close();
+				exit(ERROR_TRAFFIC_INPUT);
+			}
+
+			demand[from * numberOfRouters + to] = d;
+
+			++numberOfDemands;
+		}
+		else
+		{
+			threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
+			inFile.close();
+			exit(ERROR_TRAFFIC_INPUT);
+		}
+	}
+
+	sprintf(buffer,"	Read %d demands.",numberOfDemands);
+	threadZero->recordEvent(buffer,false,0);
+
+	inFile.close();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	buildDestinationTables
+// Description:		Builds the alias table of the destinations of
+//					every router for the destination distribution.
+//					The distances only depend on the topology, so
+//					the tables are built once on the context of the
+//					first thread.
+//
+///////////////////////////////////////////////////////////////////
+void NetworkTopology::buildDestinationTables(SimulationContext* ctx)
+{
+	if(aliasProbability != 0)
+		return;
+
+	aliasProbability = new double[numberOfRouters * numberOfRouters];
+	aliasIndex = new unsigned short int[numberOfRouters * numberOfRouters];
+
+	double* destinationProbs = new double[numberOfRouters];
+
+	for(unsigned short int src = 0; src < numberOfRouters; ++src)
+	{
+		double totalProbs = 0.0;
+
+		unsigned int pathSpans = 0;
+
+		for(unsigned int r1 = 0; r1 < numberOfRouters; ++r1)
+		{
+			if(r1 == src)
+			{
+				destinationProbs[r1] = 0.0;
+			}
+			else if(threadZero->getQualityParams().dest_dist == TRAFFIC_MATRIX)
+			{
+				destinationProbs[r1] = demand == 0 ? 0.0 : demand[src * numberOfRouters + r1];
+			}
+			else
+			{
+				pathSpans = 0;
+
+				kShortestPathReturn *kPath = ctx->getResourceManager()->calculate_SP_path(r1,src,1,ctx);
+
+				for(int r2 = 0; r2 < kPath->pathlen[0] - 1; ++r2)
+					pathSpans += threadZero->getRouterAt(kPath->pathinfo[r2])->
+						getEdgeByDestination(kPath->pathinfo[r2+1])->getNumberOfSpans();
+
+				if(threadZero->getQualityParams().dest_dist == DISTANCE)
+					destinationProbs[r1] = pathSpans;
+				else if(threadZero->getQualityParams().dest_dist == INVERSE_DISTANCE)
+					destinationProbs[r1] = 1.0 / pathSpans;
+				else
+					destinationProbs[r1] = 1.0;
+
+				delete[] kPath->pathcost;
+				delete[] kPath->pathinfo;
+				delete[] kPath->pathlen;
+
+				delete kPath;
+			}
+
+			totalProbs += destinationProbs[r1];
+		}
+
+		//A router without any demand in the traffic matrix sends to all of the others evenly
+		if(totalProbs <= 0.0)
+		{
+			for(unsigned int r1 = 0; r1 < numberOfRouters; ++r1)
+				destinationProbs[r1] = (r1 == src) ? 0.0 : 1.0;
+
+			totalProbs = numberOfRouters - 1;
+		}
+
+		for(unsigned int r2 = 0; r2 < numberOfRouters; ++r2)
+			destinationProbs[r2] = destinationProbs[r2] / totalProbs;
+
+		buildAliasTable(src,destinationProbs);
+	}
+
+	delete[] destinationProbs;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	buildAliasTable
+// Description:		Builds the alias table (Vose's method) of one
+//					router from the probability of every destination.
+//					Each slot keeps its own router with
+//					aliasProbability and hands the rest over to
+//					aliasIndex.
+//
+///////////////////////////////////////////////////////////////////
+void NetworkTopology::buildAliasTable(unsigned short int src, double* probs)
+{
+	unsigned short int n = numberOfRouters;
+
+	double* probability = &aliasProbability[src * n];
+	unsigned short int* index = &aliasIndex[src * n];
+
+	vector<unsigned short int> small;
+	vector<unsigned short int> large;
+
+	double* scaled = new double[n];
+
+	for(unsigned short int r = 0; r < n; ++r)
+	{
+		scaled[r] = probs[r] * n;
+		index[r] = r;
+
+		if(scaled[r] < 1.0)
+			small.push_back(r);
+		else
+			large.push_back(r);
+	}
+
+	while(small.empty() == false && large.empty() == false)
+	{
+		unsigned short int s = small.back();
+		unsigned short int l = large.back();
+
+		small.pop_back();
+
+		probability[s] = scaled[s];
+		index[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+
+		if(scaled[l] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+
+	//What is left over is one up to the rounding error
+	for(unsigned short int l = 0; l < large.size(); ++l)
+		probability[large[l]] = 1.0;
+
+	for(unsigned short int s = 0; s < small.size(); ++s)
+		probability[small[s]] = 1.0;
+
+	delete[] scaled;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateDestination
+// Description:		Generates a destination of the router src based
+//					upon the probability distribution. The integer
+//					part of p * n picks the slot of the alias table
+//					and the fraction picks between the slot and its
+//					alias.
+//
+///////////////////////////////////////////////////////////////////
+unsigned int NetworkTopology::generateDestination(unsigned short int src, double p)
+{
+	double slot = p * numberOfRouters;
+
+	unsigned int r = static_cast<unsigned int>(slot);
+
+	if(r >= numberOfRouters)
+		r = numberOfRouters - 1;
+
+	if(slot - r < aliasProbability[src * numberOfRouters + r])
+		return r;
+	else
+		return aliasIndex[src * numberOfRouters + r];
+}
@@ -0,0 +1,250 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      QualityPool.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the QualityPool
+//					class. The wavelengths are dealt out to the simulation
+//					thread and the helper threads in turn, which keeps the
+//					middle wavelengths with the most FWM terms spread over
+//					all of them.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, parallel Q-factor estimation.
+//
+// ____________________________________________________________________________
+
+#include "QualityPool.h"
+#include "ResourceManager.h"
+#include "Thread.h"
+
+extern Thread* threadZero;
+extern Thread** threads;
+
+struct QualityWorker
+{
+	QualityPool* pool;
+	unsigned short int index;
+};
+
+void *runQualityWorker(void* n);
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	QualityPool
+// Description:		Allocates the results for every wavelength and
+//					starts threads - 1 helper threads.
+//
+///////////////////////////////////////////////////////////////////
+QualityPool::QualityPool(unsigned short int ci, unsigned short int threadCount, unsigned short int wavelengths)
+{
+	numberOfWavelengths = wavelengths;
+
+	qFactor = new double[numberOfWavelengths];
+	xpmNoise = new double[numberOfWavelengths];
+	fwmNoise = new double[numberOfWavelengths];
+	aseNoise = new double[numberOfWavelengths];
+
+	for(unsigned short int w = 0; w < numberOfWavelengths; ++w)
+	{
+		qFactor[w] = 0.0;
+		xpmNoise[w] = 0.0;
+		fwmNoise[w] = 0.0;
+		aseNoise[w] = 0.0;
+	}
+
+	currentPath = 0;
+	currentLength = 0;
+	currentCandidates = 0;
+	currentContext = 0;
+
+	workerCount = threadCount;
+
+	if(workerCount < 1)
+		workerCount = 1;
+
+	workerGeneration = 0;
+	workersFinished = 0;
+	workerShutdown = false;
+	workers = 0;
+	workerContext = 0;
+
+	if(workerCount > 1)
+	{
+		pthread_mutex_init(&workerMutex,NULL);
+		pthread_cond_init(&workerStart,NULL);
+		pthread_cond_init(&workerDone,NULL);
+
+		workers = new pthread_t[workerCount - 1];
+		workerContext = new SimulationContext*[workerCount - 1];
+
+		for(unsigned short int w = 1; w < workerCount; ++w)
+		{
+			workerContext[w-1] = new SimulationContext(threads[ci],ci,&threadZero->getQualityParams(),
+				threadZero->getResourceManager(),threadZero->getNumberOfRouters(),threadZero->getNumberOfWavelengths());
+
+			QualityWorker* qw = new QualityWorker;
+			qw->pool = this;
+			qw->index = w;
+
+			pthread_create(&workers[w-1],NULL,runQualityWorker,qw);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~QualityPool
+// Description:		Stops the helper threads and frees the results.
+//
+///////////////////////////////////////////////////////////////////
+QualityPool::~QualityPool()
+{
+	if(workerCount > 1)
+	{
+		pthread_mutex_lock(&workerMutex);
+		workerShutdown = true;
+		++workerGeneration;
+		pthread_cond_broadcast(&workerStart);
+		pthread_mutex_unlock(&workerMutex);
+
+		for(unsigned short int w = 1; w < workerCount; ++w)
+		{
+			pthread_join(workers[w-1],NULL);
+			delete workerContext[w-1];
+		}
+
+		delete[] workers;
+		delete[] workerContext;
+
+		pthread_cond_destroy(&workerDone);
+		pthread_cond_destroy(&workerStart);
+		pthread_mutex_destroy(&workerMutex);
+	}
+
+	delete[] qFactor;
+	delete[] xpmNoise;
+	delete[] fwmNoise;
+	delete[] aseNoise;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	evaluate
+// Description:		Estimates the Q-factor of every candidate
+//					wavelength of the path, returning once all of
+//					them are known. The results of the other
+//					wavelengths are left as they were.
+//
+///////////////////////////////////////////////////////////////////
+void QualityPool::evaluate(Edge **path, unsigned short int pathLen, const bool *candidates, SimulationContext* ctx)
+{
+	currentPath = path;
+	currentLength = pathLen;
+	currentCandidates = candidates;
+	currentContext = ctx;
+
+	if(workerCount == 1)
+	{
+		evaluateSlice(0);
+		return;
+	}
+
+	pthread_mutex_lock(&workerMutex);
+	workersFinished = 0;
+	++workerGeneration;
+	pthread_cond_broadcast(&workerStart);
+	pthread_mutex_unlock(&workerMutex);
+
+	evaluateSlice(0);
+
+	pthread_mutex_lock(&workerMutex);
+
+	while(workersFinished < workerCount - 1)
+		pthread_cond_wait(&workerDone,&workerMutex);
+
+	pthread_mutex_unlock(&workerMutex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	evaluateSlice
+// Description:		Estimates the Q-factor of the candidate
+//					wavelengths assigned to worker w.
+//
+///////////////////////////////////////////////////////////////////
+void QualityPool::evaluateSlice(unsigned short int w)
+{
+	//The calling thread uses the context of the request, the helpers their own
+	SimulationContext* ctx = w == 0 ? currentContext : workerContext[w-1];
+
+	for(unsigned int k = w; k < numberOfWavelengths; k += workerCount)
+	{
+		if(currentCandidates[k] == true)
+		{
+			qFactor[k] = threadZero->getResourceManager()->estimate_Q(k,currentPath,currentLength,
+				&xpmNoise[k],&fwmNoise[k],&aseNoise[k],ctx);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runWorker
+// Description:		Main loop of a helper thread, waits for a new
+//					evaluation and runs its share of it.
+//
+///////////////////////////////////////////////////////////////////
+void QualityPool::runWorker(unsigned short int w)
+{
+	unsigned int seenGeneration = 0;
+
+	while(true)
+	{
+		pthread_mutex_lock(&workerMutex);
+
+		while(workerGeneration == seenGeneration)
+			pthread_cond_wait(&workerStart,&workerMutex);
+
+		seenGeneration = workerGeneration;
+		bool shutdown = workerShutdown;
+
+		pthread_mutex_unlock(&workerMutex);
+
+		if(shutdown == true)
+			return;
+
+		evaluateSlice(w);
+
+		pthread_mutex_lock(&workerMutex);
+
+		++workersFinished;
+
+		if(workersFinished == workerCount - 1)
+			pthread_cond_signal(&workerDone);
+
+		pthread_mutex_unlock(&workerMutex);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runQualityWorker
+// Description:		Entry point of a helper thread.
+//
+///////////////////////////////////////////////////////////////////
+void *runQualityWorker(void* n)
+{
+	QualityWorker* qw = static_cast<QualityWorker*>(n);
+
+	qw->pool->runWorker(qw->index);
+
+	delete qw;
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      ReplicationStats.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the ReplicationStats
+//					class. When every simulation is run with several random
+//					seeds (replications), the ReplicationStats collects the
+//					results of the replications and prints the mean, standard
+//					error and 95% confidence interval of each result once the
+//					last replication is done.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, statistics of independent replications.
+//
+// ____________________________________________________________________________
+
+#include "ErrorCodes.h"
+#include "ReplicationStats.h"
+#include "Thread.h"
+
+#include <math.h>
+#include <stdio.h>
+
+extern Thread* threadZero;
+
+//Two sided 95% quantiles of the Student t distribution for 1 to 30 degrees of freedom
+static const double StudentT95[30] = {
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	ReplicationStats
+// Description:		Constructor that takes the number of replications
+//					of every simulation.
+//
+///////////////////////////////////////////////////////////////////
+ReplicationStats::ReplicationStats(unsigned short int r)
+{
+	replications = r;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~ReplicationStats
+// Description:		Default destructor with no arguements.
+//
+///////////////////////////////////////////////////////////////////
+ReplicationStats::~ReplicationStats()
+{
+	jobs.clear();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addReplication
+// Description:		Stores the results of one replication of a
+//					simulation and prints the summary when it is
+//					the last one. The caller holds the results mutex.
+//
+///////////////////////////////////////////////////////////////////
+void ReplicationStats::addReplication(const string &job, const vector<string> &names, const vector<double> &values, unsigned short int ci)
+{
+	ReplicationResults &results = jobs[job];
+
+	if(results.values.size() == 0)
+	{
+		results.names = names;
+		results.values.resize(names.size());
+		results.count = 0;
+	}
+	else if(results.names.size() != names.size())
+	{
+		threadZero->recordEvent("ERROR: The replications of a simulation reported different results.\n",true,ci);
+		exit(ERROR_REPLICATION_RESULTS);
+	}
+
+	for(unsigned int m = 0; m < values.size(); ++m)
+		results.values[m].push_back(values[m]);
+
+	++results.count;
+
+	if(results.count == replications)
+	{
+		printSummary(job,results,ci);
+		jobs.erase(job);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	printSummary
+// Description:		Prints the mean, standard error and 95%
+//					confidence interval of every result over the
+//					replications.
+//
+///////////////////////////////////////////////////////////////////
+void ReplicationStats::printSummary(const string &job, ReplicationResults &results, unsigned short int ci)
+{
+	char buffer[300];
+
+	sprintf(buffer,"**REPLICATIONS = %d, %s**",results.count,job.c_str());
+	threadZero->recordEvent(buffer,true,ci);
+
+	double t = studentT95(results.count - 1);
+
+	for(unsigned int m = 0; m < results.names.size(); ++m)
+	{
+		double mean = 0.0;
+		double variance = 0.0;
+
+		for(unsigned int r = 0; r < results.values[m].size(); ++r)
+			mean += results.values[m][r];
+
+		mean /= double(results.values[m].size());
+
+		for(unsigned int r = 0; r < results.values[m].size(); ++r)
+			variance += (results.values[m][r] - mean) * (results.values[m][r] - mean);
+
+		variance /= double(results.values[m].size() - 1);
+
+		double se = sqrt(variance / double(results.values[m].size()));
+
+		sprintf(buffer,"%s: MEAN = %e, SE = %e, 95%% CI = [%e, %e]",results.names[m].c_str(),
+			mean,se,mean - t * se,mean + t * se);
+		threadZero->recordEvent(buffer,true,ci);
+	}
+
+	sprintf(buffer,"***********************************************\n");
+	threadZero->recordEvent(buffer,true,ci);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	studentT95
+// Description:		Returns the two sided 95% quantile of the Student
+//					t distribution, or of the normal distribution
+//					past 30 degrees of freedom.
+//
+///////////////////////////////////////////////////////////////////
+double ReplicationStats::studentT95(unsigned int df)
+{
+	if(df == 0)
+		return 0.0;
+	else if(df <= 30)
+		return StudentT95[df - 1];
+	else
+		return 1.960;
+}
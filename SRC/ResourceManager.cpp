@@ -19,6 +19,7 @@
 //
 // ____________________________________________________________________________
 
+#include "CounterRandom.h"
 #include "ErrorCodes.h"
 #include "ResourceManager.h"
 #include "Thread.h"
@@ -28,8 +29,8 @@
 #include "pthread.h"
 
 #include <cmath>
-
-#include "boost/random.hpp"
+#include <limits>
+#include <string.h>
 
 extern Thread* threadZero;
 extern Thread** threads;
@@ -37,9 +38,23 @@ extern Thread** threads;
 short int minInt(short int a, short int b);
 
 extern "C" void calc_k_shortest_paths(const kShortestPathParms &params, kShortestPathReturn* retVal);
+extern "C" void calc_k_shortest_paths_budget(const kShortestPathParms &params, kShortestPathReturn* retVal, kShortestPathBudget budget, void* budgetData);
 
 extern char* itoa( int value, char* result, int base );
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	chargeKShortestPathBudget
+// Description:		Charges one operation to the compute budget of
+//					simulation for every path found by the k
+//					shortest path library.
+//
+///////////////////////////////////////////////////////////////////
+static bool chargeKShortestPathBudget(void* data)
+{
+	return static_cast<SimulationContext*>(data)->chargeRouteBudget(1);
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	ResourceManager
@@ -48,18 +63,24 @@ extern char* itoa( int value, char* result, int base );
 ///////////////////////////////////////////////////////////////////
 ResourceManager::ResourceManager()
 {
-	SP_paths = 0;
 	kSP_edgeList = 0;
 	wave_ordering = 0;
 
 	sys_fs = new double[threadZero->getNumberOfWavelengths()];
 	sys_link_xpm_database = new double[threadZero->getNumberOfWavelengths() * threadZero->getNumberOfWavelengths()];
 
+	//Built here so that the tables are never written once the threads are running
+	build_KSP_EdgeList();
+
 	calc_min_spans();
 
 	build_nonlinear_datastructure();
 
+	build_physical_parameters();
+
 	precompute_fwm_combinations();
+
+	generateWaveOrdering();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -73,30 +94,69 @@ ResourceManager::~ResourceManager()
 	delete[] sys_fs;
 	delete[] sys_link_xpm_database;
 
+	delete[] physical.lambdac;
+
 	delete[] wave_ordering;
 
 	delete[] span_distance;
 
-	for(unsigned int s = 0; s < fwm_combinations->size(); ++s)
-		fwm_combinations[s].clear();
+	free_fwm_combinations();
 
-	for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
-	{
-		delete[] (*fwm_fs)[w];
-		delete[] (*inter_indecies)[w];
-	}
-	
-	fwm_fs->clear();
-	inter_indecies->clear();
+	delete[] kSP_edgeList;
+}
 
-	delete[] fwm_combinations;
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	updateParameters
+// Description:		Brings the tables up to date with the quality
+//					parameters of the next run. Only the tables whose
+//					inputs differ from the previous parameters are
+//					rebuilt, the tables of the topology are kept.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::updateParameters(const QualityParameters &previous)
+{
+	const QualityParameters &qp = threadZero->getQualityParams();
 
-	delete[] fwm_fs;
-	delete[] inter_indecies;
+	bool frequencies = qp.fc != previous.fc || qp.f_step != previous.f_step ||
+		qp.halfwavelength != previous.halfwavelength;
 
-	freeSPMatrix();
+	bool xpm = frequencies || qp.nonlinear_halfwin != previous.nonlinear_halfwin ||
+		qp.channel_power != previous.channel_power || qp.D != previous.D ||
+		qp.alphaDB != previous.alphaDB || qp.gamma != previous.gamma;
 
-	delete[] kSP_edgeList;
+	bool combinations = frequencies || qp.nonlinear_halfwin != previous.nonlinear_halfwin;
+
+	bool terms = combinations || qp.channel_power != previous.channel_power ||
+		qp.D != previous.D || qp.S != previous.S || qp.L != previous.L ||
+		qp.alphaDB != previous.alphaDB || qp.gamma != previous.gamma;
+
+	if(xpm == true)
+		build_nonlinear_datastructure();
+
+	threadZero->setMinDuration(maxMinDistance);
+
+	threadZero->setQFactorMin(maxMinDistance);
+
+	//The constants of the Q-factor are cheap, so they are always recalculated
+	delete[] physical.lambdac;
+	build_physical_parameters();
+
+	if(combinations == true)
+	{
+		free_fwm_combinations();
+		precompute_fwm_combinations();
+	}
+	else if(terms == true)
+	{
+		for(int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
+			build_fwm_terms(w);
+	}
+
+	char buffer[200];
+	sprintf(buffer,"REBUILT TABLES: XPM = %d, FWM COMBINATIONS = %d, FWM TERMS = %d",
+		int(xpm),int(combinations),int(terms));
+	threadZero->recordEvent(buffer,true,0);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -106,17 +166,15 @@ ResourceManager::~ResourceManager()
 //					destination for the SP algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_SP_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_SP_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
-	if(threads[ci]->getCurrentRoutingAlgorithm() == SHORTEST_PATH)
+	if(ctx->getThread()->getCurrentRoutingAlgorithm() == SHORTEST_PATH)
 	{
-		if(SP_paths != 0)
-			if(SP_paths[src * threadZero->getNumberOfRouters() + dest] != 0)
-				return SP_paths[src * threadZero->getNumberOfRouters() + dest];
-	}
+		kShortestPathReturn *cached = ctx->getSPPath(src,dest);
 
-	if(kSP_edgeList == 0)
-		build_KSP_EdgeList();
+		if(cached != 0)
+			return cached;
+	}
 
 	kShortestPathParms kSP_params;
 
@@ -142,14 +200,14 @@ kShortestPathReturn* ResourceManager::calculate_SP_path(unsigned short int src,
 	kSP_return->pathcost = new float[kSP_params.k_paths];
 	kSP_return->pathlen = new unsigned short int[kSP_params.k_paths];
 
-	calc_k_shortest_paths(kSP_params, kSP_return);
+	calc_k_shortest_paths_budget(kSP_params, kSP_return, chargeKShortestPathBudget, ctx);
 
 	delete[] kSP_params.edge_list;
 
-	if(threads[ci]->getCurrentRoutingAlgorithm() == SHORTEST_PATH)
+	//Paths cut short by the compute budget are not kept for later requests.
+	if(ctx->getThread()->getCurrentRoutingAlgorithm() == SHORTEST_PATH && ctx->getRouteBudgetCut() == false)
 	{
-		if(SP_paths != 0)
-			SP_paths[src * threadZero->getNumberOfRouters() + dest] = kSP_return;
+		ctx->setSPPath(src,dest,kSP_return);
 	}
 
 	return kSP_return;
@@ -166,9 +224,6 @@ unsigned short int ResourceManager::calculate_span_distance(unsigned short int s
 {
 	unsigned short int retVal = 0;
 
-	if(kSP_edgeList == 0)
-		build_KSP_EdgeList();
-
 	kShortestPathParms kSP_params;
 
 	kSP_params.src_node = src;
@@ -210,11 +265,8 @@ unsigned short int ResourceManager::calculate_span_distance(unsigned short int s
 //					destination for the LORA algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_LORA_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_LORA_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
-	if(kSP_edgeList == 0)
-		build_KSP_EdgeList();
-
 	kShortestPathParms kSP_params;
 
 	kSP_params.src_node = src;
@@ -230,7 +282,7 @@ kShortestPathReturn* ResourceManager::calculate_LORA_path(unsigned short int src
 
 	for(unsigned short int a = 0; a < threadZero->getNumberOfRouters(); ++a)
 	{
-		Router* routerA = threads[ci]->getRouterAt(a);
+		Router* routerA = ctx->getThread()->getRouterAt(a);
 
 		for(unsigned short int b = 0; b < threadZero->getNumberOfRouters(); ++b)
 		{
@@ -252,7 +304,7 @@ kShortestPathReturn* ResourceManager::calculate_LORA_path(unsigned short int src
 	kSP_return->pathcost = new float[kSP_params.k_paths];
 	kSP_return->pathlen = new unsigned short int[kSP_params.k_paths];
 
-	calc_k_shortest_paths(kSP_params, kSP_return);
+	calc_k_shortest_paths_budget(kSP_params, kSP_return, chargeKShortestPathBudget, ctx);
 
 	delete[] kSP_params.edge_list;
 
@@ -266,7 +318,7 @@ kShortestPathReturn* ResourceManager::calculate_LORA_path(unsigned short int src
 //					destination for the IA-BF algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_IA_path(unsigned short int src, unsigned short int dest, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_IA_path(unsigned short int src, unsigned short int dest, SimulationContext* ctx)
 {
 	kShortestPathParms* kSP_params = new kShortestPathParms[threadZero->getNumberOfWavelengths()];
 
@@ -283,7 +335,7 @@ kShortestPathReturn* ResourceManager::calculate_IA_path(unsigned short int src,
 
 	for(unsigned short int a = 0; a < threadZero->getNumberOfRouters(); ++a)
 	{
-		Router* routerA = threads[ci]->getRouterAt(a);
+		Router* routerA = ctx->getThread()->getRouterAt(a);
 
 		for(unsigned short int b = 0; b < threadZero->getNumberOfRouters(); ++b)
 		{
@@ -324,14 +376,18 @@ kShortestPathReturn* ResourceManager::calculate_IA_path(unsigned short int src,
 
 	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
-		calc_k_shortest_paths(kSP_params[w],kSP_temp);
+		//A cancelled speculation is thrown away, so the remaining wavelengths are skipped
+		if(ctx->isSpeculationCancelled() == false)
+		{
+			calc_k_shortest_paths(kSP_params[w],kSP_temp);
 
-		kSP_return->pathcost[w] = kSP_temp->pathcost[0];
-		kSP_return->pathlen[w] = kSP_temp->pathlen[0];
+			kSP_return->pathcost[w] = kSP_temp->pathcost[0];
+			kSP_return->pathlen[w] = kSP_temp->pathlen[0];
 
-		if(kSP_return->pathlen[w] != std::numeric_limits<int>::infinity())
-			for(unsigned short int p = 0; p < kSP_return->pathlen[w]; ++p)
-				kSP_return->pathinfo[w * (kSP_params[0].total_nodes - 1) + p] = kSP_temp->pathinfo[p];
+			if(kSP_return->pathlen[w] != std::numeric_limits<int>::infinity())
+				for(unsigned short int p = 0; p < kSP_return->pathlen[w]; ++p)
+					kSP_return->pathinfo[w * (kSP_params[0].total_nodes - 1) + p] = kSP_temp->pathinfo[p];
+		}
 
 		delete[] kSP_params[w].edge_list;
 	}
@@ -354,7 +410,7 @@ kShortestPathReturn* ResourceManager::calculate_IA_path(unsigned short int src,
 //					destination for the PAR algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_PAR_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_PAR_path(unsigned short int src_index, unsigned short int dest_index, unsigned short int k, SimulationContext* ctx)
 {
 	unsigned short int iterationCount = 1;
 	unsigned short int kPathsFound = 0;
@@ -379,7 +435,7 @@ kShortestPathReturn* ResourceManager::calculate_PAR_path(unsigned short int src_
 			kProduct = static_cast<unsigned short int>(pow(float(k),iterationCount));
 		}
 
-		kShortestPathReturn* lora_ksp = calculate_LORA_path(src_index,dest_index,kProduct,ci);
+		kShortestPathReturn* lora_ksp = calculate_LORA_path(src_index,dest_index,kProduct,ctx);
 
 		kPathsFound = 0;
 		kPathsStatus = new unsigned short int[kProduct];
@@ -456,9 +512,9 @@ kShortestPathReturn* ResourceManager::calculate_PAR_path(unsigned short int src_
 		}
 
 		//If we haven't found k paths that satisify the constraints after MAX_ITERATIONS,
-		//then we just return the c paths that do satisfy the constraints and the first
-		//k - c paths that do not satisfy the constraints.
-		if(iterationCount == MAX_ITERATIONS)
+		//or the compute budget has run out, then we just return the c paths that do
+		//satisfy the constraints and the first k - c paths that do not satisfy the constraints.
+		if(iterationCount == MAX_ITERATIONS || ctx->getRouteBudgetCut() == true)
 		{
 			kShortestPathReturn *kSP_return = new kShortestPathReturn();
 
@@ -491,9 +547,17 @@ kShortestPathReturn* ResourceManager::calculate_PAR_path(unsigned short int src_
 			//Return the first k - c paths that do not satisfy the constraints
 			for(unsigned int c = kPathsFound; c < k; ++c)
 			{
-				while(kPathsStatus[kIndex] != PATH_TOO_LONG)
+				while(kIndex < kProduct && kPathsStatus[kIndex] != PATH_TOO_LONG)
 					++kIndex;
 
+				//There may not be enough of them, the rest have no path.
+				if(kIndex == kProduct)
+				{
+					kSP_return->pathcost[c] = std::numeric_limits<float>::infinity();
+					kSP_return->pathlen[c] = std::numeric_limits<int>::infinity();
+					continue;
+				}
+
 				kSP_return->pathcost[c] = lora_ksp->pathcost[kIndex];
 				kSP_return->pathlen[c] = lora_ksp->pathlen[kIndex];
 
@@ -538,11 +602,8 @@ kShortestPathReturn* ResourceManager::calculate_PAR_path(unsigned short int src_
 //					destination for the QM algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_QM_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_QM_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
-	if(kSP_edgeList == 0)
-		build_KSP_EdgeList();
-
 	kShortestPathParms kSP_params;
 
 	kSP_params.src_node = src;
@@ -558,7 +619,7 @@ kShortestPathReturn* ResourceManager::calculate_QM_path(unsigned short int src,
 
 	for(unsigned short int a = 0; a < threadZero->getNumberOfRouters(); ++a)
 	{
-		Router* routerA = threads[ci]->getRouterAt(a);
+		Router* routerA = ctx->getThread()->getRouterAt(a);
 
 		for(unsigned short int b = 0; b < threadZero->getNumberOfRouters(); ++b)
 		{
@@ -566,7 +627,7 @@ kShortestPathReturn* ResourceManager::calculate_QM_path(unsigned short int src,
 
 			if(edgeID >= 0)
 			{
-				kSP_params.edge_list[num].edge_cost = routerA->getEdgeByIndex(edgeID)->getQMDegredation();
+				kSP_params.edge_list[num].edge_cost = routerA->getEdgeByIndex(edgeID)->getQMDegredation(ctx);
 
 				++num;
 			}
@@ -579,7 +640,7 @@ kShortestPathReturn* ResourceManager::calculate_QM_path(unsigned short int src,
 	kSP_return->pathcost = new float[kSP_params.k_paths];
 	kSP_return->pathlen = new unsigned short int[kSP_params.k_paths];
 
-	calc_k_shortest_paths(kSP_params, kSP_return);
+	calc_k_shortest_paths_budget(kSP_params, kSP_return, chargeKShortestPathBudget, ctx);
 
 	delete[] kSP_params.edge_list;
 
@@ -593,10 +654,10 @@ kShortestPathReturn* ResourceManager::calculate_QM_path(unsigned short int src,
 //					destination for the AQoS algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_AQoS_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_AQoS_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
 	//First calculate the 2k shortest paths via the QM method
-	kShortestPathReturn* QM_paths = calculate_QM_path(src,dest,k * 2,ci);
+	kShortestPathReturn* QM_paths = calculate_QM_path(src,dest,k * 2,ctx);
 	unsigned int* QM_paths_availability = new unsigned int[k * 2];
 
 	//Determine the amount of wavelengths available on each edge.
@@ -617,7 +678,7 @@ kShortestPathReturn* ResourceManager::calculate_AQoS_path(unsigned short int src
 					unsigned short int srcIndex = QM_paths->pathinfo[p * (threadZero->getNumberOfRouters() - 1) + r];
 					unsigned short int destIndex = QM_paths->pathinfo[p * (threadZero->getNumberOfRouters() - 1) + r + 1];
 
-					if(threads[ci]->getRouterAt(srcIndex)->getEdgeByDestination(destIndex)->getStatus(w) == EDGE_USED)
+					if(ctx->getThread()->getRouterAt(srcIndex)->getEdgeByDestination(destIndex)->getStatus(w) == EDGE_USED)
 					{
 						--QM_paths_availability[p];
 						break;
@@ -693,252 +754,9 @@ kShortestPathReturn* ResourceManager::calculate_AQoS_path(unsigned short int src
 //					destination for the ACO algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_ACO_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_ACO_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
-	double alpha = threadZero->getQualityParams().DP_alpha;
-
-	double l_exp = (double(threadZero->getMaxSpans()) + double(span_distance[src * threadZero->getNumberOfRouters() + dest])) / 2.0;
-	double Q_exp = 10.0 * log10(threadZero->getQualityParams().channel_power/sqrt(l_exp * threadZero->getQualityParams().ASE_perEDFA[threadZero->getQualityParams().halfwavelength]));
-
-	kShortestPathReturn* kSP_return = new kShortestPathReturn();
-
-	kSP_return->pathcost = new float[k];
-	kSP_return->pathlen = new unsigned short int[k];
-	kSP_return->pathinfo = new unsigned short int[k * threadZero->getNumberOfRouters() - 1];
-
-	for(unsigned int k1 = 0; k1 < k; ++k1)
-	{
-		kSP_return->pathcost[k1] = 0.0;
-		kSP_return->pathlen[k1] = 0;
-	}
-
-	for(unsigned n = 0; n < threadZero->getNumberOfRouters(); ++n)
-	{
-		for(unsigned int e = 0; e < threads[ci]->getRouterAt(n)->getNumberOfEdges(); ++e)
-		{
-			threads[ci]->getRouterAt(n)->getEdgeByIndex(e)->resetPheremone(ci,
-				span_distance[src * threadZero->getNumberOfRouters() + dest]);
-		}
-
-		threads[ci]->getRouterAt(n)->generateACOProbabilities(dest);
-	}
-
-	for(unsigned int i = 0; i < threadZero->getQualityParams().MM_ACO_N_iter; ++i)
-	{
-		Ant *ants = new Ant[threadZero->getQualityParams().ACO_ants];
-
-		for(unsigned int a = 0; a < threadZero->getQualityParams().ACO_ants; ++a)
-		{
-			ants[a].location = threads[ci]->getRouterAt(src);
-			ants[a].pathlen = 0;
-			ants[a].path = new Edge*[threadZero->getNumberOfRouters() - 1];
-
-			while(ants[a].location != threads[ci]->getRouterAt(dest) && ants[a].pathlen + 1 < threadZero->getNumberOfRouters() - 1)
-			{
-				Edge *new_edge = ants[a].location->chooseEdge((*(threads[ci]->generateZeroToOne))());
-
-				ants[a].location = threads[ci]->getRouterAt(new_edge->getDestinationIndex());
-				ants[a].path[ants[a].pathlen] = new_edge;
-				++ants[a].pathlen;
-
-				for(unsigned int p = 0; p < ants[a].pathlen - 1; ++p)
-				{
-					if(ants[a].path[ants[a].pathlen - 1]->getDestinationIndex() == ants[a].path[p]->getSourceIndex())
-					{
-						ants[a].location = threads[ci]->getRouterAt(src);
-						ants[a].pathlen = 0;
-
-						break;
-					}
-				}
-			}
-
-			bool *free = new bool[threadZero->getNumberOfWavelengths()];
-
-			for(unsigned int w1 = 0; w1 < threadZero->getNumberOfWavelengths(); ++w1)
-			{
-				free[w1] = true;
-			}
-
-			unsigned int spans = 0;
-
-			for(unsigned int e = 0; e < ants[a].pathlen; ++e)
-			{
-				for(unsigned int w2 = 0; w2 < threadZero->getNumberOfWavelengths(); ++w2)
-				{
-					if(ants[a].path[e]->getStatus(w2) != EDGE_FREE)
-						free[w2] = false;
-				}
-
-				spans += ants[a].path[e]->getNumberOfSpans();
-			}
-
-			double bestQ = 0.0;
-			float pathWeight = 0.0;
-
-			for(unsigned int w3 = 0; w3 < threadZero->getNumberOfWavelengths(); ++w3)
-			{
-				double ase;
-				double fwm;
-				double xpm;
-				double Q;
-
-				if(free[w3] == true)
-				{
-					Q = threadZero->getResourceManager()->estimate_Q(w3,ants[a].path,ants[a].pathlen,&xpm,&fwm,&ase,ci);
-
-					if(Q > bestQ)
-					{
-						bestQ = Q;
-					}
-				}
-			}
-
-			delete[] free;
-
-			pathWeight = (1.0 - alpha) * (bestQ / Q_exp) + alpha * l_exp / double(spans);
-
-			if(pathWeight > kSP_return->pathcost[k-1] && bestQ  >= threadZero->getQualityParams().TH_Q)
-			{
-				//Check for duplicates....we need to keep k distinct paths!
-				bool uniqueK = false;
-
-				for(unsigned int k0 = 0; k0 < k; ++k0)
-				{
-					uniqueK = false;
-
-					for(unsigned int r = 0; r < ants[a].pathlen; ++r)
-					{
-						if(ants[a].path[r]->getSourceIndex() !=
-							kSP_return->pathinfo[k0 * (threadZero->getNumberOfRouters() - 1) + r])
-						{
-							uniqueK = true;
-							break;
-						}
-					}
-
-					if(uniqueK == false)
-					{
-						break;
-					}
-				}
-
-				//We need to add unique paths only.
-				if(uniqueK == true)
-				{
-					if(threads[ci]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
-					{
-						i = 0;
-					}
-
-					//Calculate where to insert into the dest_node structure
-					unsigned int k1 = k - 1;
-					unsigned int k2 = 0;
-
-					while(k1 > 0 && pathWeight > kSP_return->pathcost[k1-1])
-					{
-						--k1;
-					}
-
-					k2 = k - 1;
-
-					while(k2 > k1)
-					{
-						for(unsigned int n = 0; n < threadZero->getNumberOfRouters() - 1; ++n)
-						{
-							kSP_return->pathinfo[k2 * (threadZero->getNumberOfRouters() - 1) + n] =
-								kSP_return->pathinfo[(k2-1) * (threadZero->getNumberOfRouters() - 1) + n];
-						}
-
-						kSP_return->pathlen[k2] = kSP_return->pathlen[k2-1];
-						kSP_return->pathcost[k2] = kSP_return->pathcost[k2-1];
-
-						--k2;
-					}
-
-					//Insert where appropriate
-					for(unsigned int n = 0; n < ants[a].pathlen; ++n)
-					{
-						kSP_return->pathinfo[k1 * (threadZero->getNumberOfRouters() - 1) + n] = 
-							ants[a].path[n]->getSourceIndex();
-					}
-
-					kSP_return->pathinfo[k1 * (threadZero->getNumberOfRouters() - 1) + ants[a].pathlen] =
-						ants[a].path[ants[a].pathlen - 1]->getDestinationIndex();
-
-					kSP_return->pathlen[k1] = ants[a].pathlen + 1;
-					kSP_return->pathcost[k1] = pathWeight;
-				}
-			}
-		}
-
-		for(unsigned n = 0; n < threadZero->getNumberOfRouters(); ++n)
-		{
-			for(unsigned int e = 0; e < threads[ci]->getRouterAt(n)->getNumberOfEdges(); ++e)
-			{
-				threads[ci]->getRouterAt(n)->getEdgeByIndex(e)->evaporatePheremone(ci);
-			}
-		}
-
-		for(unsigned int a2 = 0; a2 < threadZero->getQualityParams().ACO_ants; ++a2)
-		{
-			if(threads[ci]->getCurrentRoutingAlgorithm() == ACO)
-			{
-				if(ants[a2].pathlen > 0)
-				{
-					unsigned int spans = 0;
-
-					for(unsigned int n1 = 0; n1 < ants[a2].pathlen; ++n1)
-					{
-						spans += ants[a2].path[n1]->getNumberOfSpans();
-					}
-					for(unsigned int n2 = 0; n2 < ants[a2].pathlen; ++n2)
-					{
-						ants[a2].path[n2]->addPheremone(spans,ci);
-					}				
-				}
-			}
-
-			delete[] ants[a2].path;
-		}
-
-		if(threads[ci]->getCurrentRoutingAlgorithm() == MAX_MIN_ACO)
-		{
-			if(kSP_return->pathlen[0] > 0)
-			{
-				unsigned int spans = 0;
-
-				for(unsigned int n1 = 0; n1 < kSP_return->pathlen[0] - 1; ++n1)
-				{
-					spans += threads[ci]->getRouterAt(kSP_return->pathinfo[n1])->
-						getEdgeByDestination(kSP_return->pathinfo[n1+1])->getNumberOfSpans();
-				}
-				for(unsigned int n2 = 0; n2 < kSP_return->pathlen[0] - 1; ++n2)
-				{
-					threads[ci]->getRouterAt(kSP_return->pathinfo[n2])->getEdgeByDestination(kSP_return->pathinfo[n2+1])->
-						addPheremone(spans,ci);
-				}
-			}
-		}
-
-		for(unsigned n2 = 0; n2 < threadZero->getNumberOfRouters(); ++n2)
-		{
-			threads[ci]->getRouterAt(n2)->generateACOProbabilities(dest);
-		}
-
-		delete[] ants;
-	}
-
-	for(unsigned int k1 = 0; k1 < k; ++k1)
-	{
-		if(kSP_return->pathlen[k1] == 0 && threads[ci]->getCurrentRoutingAlgorithm() == ACO)
-		{
-			kSP_return->pathcost[k1] = std::numeric_limits<float>::infinity();
-			kSP_return->pathlen[k1] = std::numeric_limits<int>::infinity();
-		}
-	}
-
-	return kSP_return;
+	return ctx->getThread()->getAntColony()->calculate_path(src,dest,k,true);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -948,7 +766,7 @@ kShortestPathReturn* ResourceManager::calculate_ACO_path(unsigned short int src,
 //					destination for the Max Min ACO algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_MM_ACO_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_MM_ACO_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
 	kShortestPathReturn* kSP_return = new kShortestPathReturn();
 	kShortestPathReturn** mmACO_iters = new kShortestPathReturn*[threadZero->getQualityParams().MM_ACO_N_reset + 1];
@@ -963,9 +781,13 @@ kShortestPathReturn* ResourceManager::calculate_MM_ACO_path(unsigned short int s
 		kSP_return->pathlen[k1] = 0;
 	}
 
+	unsigned int colonies = 0;
+
 	for(unsigned int r = 0; r <= threadZero->getQualityParams().MM_ACO_N_reset; ++r)
 	{
-		mmACO_iters[r] = this->calculate_ACO_path(src,dest,k,ci);
+		//Only the first colony may start from the stored pheremone, the
+		//others are the reinitializations of Max Min ACO.
+		mmACO_iters[r] = ctx->getThread()->getAntColony()->calculate_path(src,dest,k,r == 0);
 
 		for(unsigned int k2 = 0; k2 < k; ++k2)
 		{
@@ -1009,6 +831,12 @@ kShortestPathReturn* ResourceManager::calculate_MM_ACO_path(unsigned short int s
 				kSP_return->pathcost[k3] = mmACO_iters[r]->pathcost[k2];
 			}
 		}
+
+		++colonies;
+
+		//Skip the remaining reinitializations once the compute budget has run out.
+		if(ctx->getRouteBudgetCut() == true)
+			break;
 	}
 
 	for(unsigned int k5 = 0; k5 < k; ++k5)
@@ -1020,7 +848,7 @@ kShortestPathReturn* ResourceManager::calculate_MM_ACO_path(unsigned short int s
 		}
 	}
 
-	for(unsigned int r = 0; r <= threadZero->getQualityParams().MM_ACO_N_reset; ++r)
+	for(unsigned int r = 0; r < colonies; ++r)
 	{
 		delete[] mmACO_iters[r]->pathcost;
 		delete[] mmACO_iters[r]->pathinfo;
@@ -1041,7 +869,7 @@ kShortestPathReturn* ResourceManager::calculate_MM_ACO_path(unsigned short int s
 //					destination for the DP algorithm
 //
 ///////////////////////////////////////////////////////////////////
-kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src, unsigned short int dest, unsigned short int k, unsigned short int ci)
+kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src, unsigned short int dest, unsigned short int k, SimulationContext* ctx)
 {
 	double alpha = threadZero->getQualityParams().DP_alpha;
 
@@ -1063,6 +891,12 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 	double l_exp = (double(threadZero->getMaxSpans()) + double(span_distance[src * threadZero->getNumberOfRouters() + dest])) / 2.0;
 	double Q_exp = 10.0 * log10(threadZero->getQualityParams().channel_power/sqrt(l_exp * threadZero->getQualityParams().ASE_perEDFA[threadZero->getQualityParams().halfwavelength]));
 
+	//With alpha at one the search stops at the first wavelength that passes, so it is left on this thread
+	QualityPool* pool = alpha < 1.0 && ctx->isSpeculative() == false ? ctx->getThread()->getQualityPool() : 0;
+
+	//The nodes are local to the request, so routes may be calculated on several threads at once
+	DP_node** dp_nodes = new DP_node*[threadZero->getNumberOfRouters()];
+
 	for(unsigned int r1 = 0; r1 < threadZero->getNumberOfRouters(); ++r1)
 	{
 		DP_node* node = new DP_node();
@@ -1093,12 +927,12 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 			node->pathWeight[k1] = 0.0;
 		}
 
-		threads[ci]->getRouterAt(r1)->dp_node = node;
+		dp_nodes[r1] = node;
 	}
 
 	queue<DP_item*> Q;
 
-	for(unsigned int e = 0; e < threads[ci]->getRouterAt(src)->getNumberOfEdges(); ++e)
+	for(unsigned int e = 0; e < ctx->getThread()->getRouterAt(src)->getNumberOfEdges(); ++e)
 	{
 		bool addEdge = false;
 		DP_item* item = new DP_item;
@@ -1106,7 +940,7 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 		item->path = new Edge*[threadZero->getNumberOfRouters() - 1];
 		item->waveAvailability = new bool[threadZero->getNumberOfWavelengths()];
 
-		item->path[0] = threads[ci]->getRouterAt(src)->getEdgeByIndex(e);
+		item->path[0] = ctx->getThread()->getRouterAt(src)->getEdgeByIndex(e);
 
 		item->pathLength = 1;
 		item->pathSpans = item->path[0]->getNumberOfSpans();
@@ -1142,7 +976,7 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 
 		Edge* edge = current_item->path[current_item->pathLength-1];
 
-		DP_node *dest_node = threads[ci]->getRouterAt(edge->getDestinationIndex())->dp_node;
+		DP_node *dest_node = dp_nodes[edge->getDestinationIndex()];
 
 		unsigned int additionalSpans = span_distance[edge->getDestinationIndex() * threadZero->getNumberOfRouters() + dest];
 
@@ -1154,6 +988,9 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 			double waveWeight = 0.0;
 			unsigned int bestW = 0;
 
+			if(pool != 0)
+				pool->evaluate(&current_item->path[0],current_item->pathLength,current_item->waveAvailability,ctx);
+
 			for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 			{
 				double ase = 0.0;
@@ -1167,7 +1004,10 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 
 				if(current_item->waveAvailability[w] == true)
 				{
-					Q = threadZero->getResourceManager()->estimate_Q(w,&current_item->path[0],current_item->pathLength,&xpm,&fwm,&ase,ci);
+					if(pool != 0)
+						Q = pool->getQ(w,&xpm,&fwm,&ase);
+					else
+						Q = threadZero->getResourceManager()->estimate_Q(w,&current_item->path[0],current_item->pathLength,&xpm,&fwm,&ase,ctx);
 
 					bestCaseASE = additionalSpans * threadZero->getQualityParams().ASE_perEDFA[threadZero->getQualityParams().halfwavelength];
 					bestCaseQ = 10.0 * log10(threadZero->getQualityParams().channel_power/sqrt(bestCaseASE + ase + xpm + fwm));
@@ -1259,9 +1099,9 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 					dest_node->optimalWave[k1] = bestW;
 					dest_node->pathWeight[k1] = pathWeight;
 
-					for(unsigned int e = 0; e < threads[ci]->getRouterAt(edge->getDestinationIndex())->getNumberOfEdges(); ++e)
+					for(unsigned int e = 0; e < ctx->getThread()->getRouterAt(edge->getDestinationIndex())->getNumberOfEdges(); ++e)
 					{
-						Edge* tmp_edge = threads[ci]->getRouterAt(edge->getDestinationIndex())->getEdgeByIndex(e);
+						Edge* tmp_edge = ctx->getThread()->getRouterAt(edge->getDestinationIndex())->getEdgeByIndex(e);
 
 						//We don't want to put edges with a destinaton of the source on the Q.
 						//This would result in a cycle.
@@ -1292,8 +1132,8 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 						item->pathSpans = current_item->pathSpans + tmp_edge->getNumberOfSpans();
 
 						if(item->pathSpans > threadZero->getMaxSpans() ||
-							(alpha == 0 && item->pathSpans > threadZero->getRouterAt(tmp_edge->getDestinationIndex())->dp_node->pathSpans[k-1] &&
-							threadZero->getRouterAt(tmp_edge->getDestinationIndex())->dp_node->pathSpans[k-1] != 0))
+							(alpha == 0 && item->pathSpans > dp_nodes[tmp_edge->getDestinationIndex()]->pathSpans[k-1] &&
+							dp_nodes[tmp_edge->getDestinationIndex()]->pathSpans[k-1] != 0))
 						{
 							delete[] item->path;
 							delete[] item->waveAvailability;
@@ -1335,6 +1175,19 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 		delete[] current_item->waveAvailability;
 
 		delete current_item;
+
+		//Once the compute budget has run out, the best paths found so far are returned.
+		if(ctx->chargeRouteBudget(1) == true)
+		{
+			while(Q.size() > 0)
+			{
+				delete[] Q.front()->path;
+				delete[] Q.front()->waveAvailability;
+
+				delete Q.front();
+				Q.pop();
+			}
+		}
 	}
 
 	k = origK;
@@ -1346,7 +1199,7 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 	kSP_return->pathlen = new unsigned short int[k];
 	kSP_return->pathinfo = new unsigned short int[k * threadZero->getNumberOfRouters() - 1];
 
-	DP_node* final_dp_node  = threads[ci]->getRouterAt(dest)->dp_node;
+	DP_node* final_dp_node  = dp_nodes[dest];
 
 	for(unsigned int k1 = 0; k1 < k; ++k1)
 	{
@@ -1373,7 +1226,7 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 
 	for(unsigned int r1 = 0; r1 < threadZero->getNumberOfRouters(); ++r1)
 	{
-		DP_node *node = threads[ci]->getRouterAt(r1)->dp_node;
+		DP_node *node = dp_nodes[r1];
 
 		delete[] node->paths;
 		delete[] node->waveAvailability;
@@ -1386,17 +1239,23 @@ kShortestPathReturn* ResourceManager::calculate_DP_path(unsigned short int src,
 		delete node;
 	}
 
+	delete[] dp_nodes;
+
 	return kSP_return;
 }
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	choose_wavelength
-// Description:		Calculates the shortest path from source to
-//					destination for the SP algorithm
+// Function Name:	assign_wavelength
+// Description:		Chooses the wavelength of the probe with the
+//					wavelength algorithm WA, and checks its quality
+//					when the job is quality aware (QA). There is a
+//					copy of this function for every combination, so
+//					none of them are checked at run time.
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigned short int ci)
+template <WavelengthAlgorithm WA, bool QA>
+int ResourceManager::assign_wavelength(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx)
 {
 	int retval;
 
@@ -1408,11 +1267,11 @@ int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigne
 
 	for(unsigned short int r = 0; r < ccpe->connectionLength; ++r)
 	{
-		Edge* edge = ccpe->connectionPath[r];
+		const int *state = ccpe->connectionPath[r]->getLinkState();
 
 		for(unsigned short int k = 0; k < threadZero->getNumberOfWavelengths(); ++k)
 		{
-			if(edge->getStatus(k) != EDGE_FREE && wave_available[k] == true)
+			if(state[k] != LINK_STATE_FREE && wave_available[k] == true)
 			{
 				wave_available[k] = false;
 				--numberAvailableWaves;
@@ -1427,53 +1286,53 @@ int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigne
 		return NO_PATH_FAILURE;
 	}
 
-	if(threads[ci]->getCurrentWavelengthAlgorithm() == FIRST_FIT)
+	if(WA == FIRST_FIT)
 	{
-		retval = first_fit(ccpe,ci,wave_available);
+		retval = first_fit(ccpe,ctx,wave_available);
 		delete[] wave_available;
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == FIRST_FIT_ORDERED)
+	else if(WA == FIRST_FIT_ORDERED)
 	{
-		retval = first_fit_with_ordering(ccpe,ci,wave_available);
+		retval = first_fit_with_ordering(ccpe,ctx,wave_available);
 		delete[] wave_available;
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == RANDOM_FIT)
+	else if(WA == RANDOM_FIT)
 	{
-		retval = random_fit(ccpe,ci,wave_available,numberAvailableWaves);
+		retval = random_fit(ccpe,ctx,wave_available,numberAvailableWaves);
 		delete[] wave_available;
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == MOST_USED)
+	else if(WA == MOST_USED)
 	{
-		retval = most_used(ccpe,ci,wave_available);
+		retval = most_used(ccpe,ctx,wave_available);
 		delete[] wave_available;
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == QUAL_FIRST_FIT)
+	else if(WA == QUAL_FIRST_FIT)
 	{
-		return quality_first_fit(ccpe,ci,wave_available,numberAvailableWaves);
+		return quality_first_fit(ccpe,ctx,wave_available,numberAvailableWaves);
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == QUAL_FIRST_FIT_ORDERED)
+	else if(WA == QUAL_FIRST_FIT_ORDERED)
 	{
-		return quality_first_fit_with_ordering(ccpe,ci,wave_available,numberAvailableWaves);
+		return quality_first_fit_with_ordering(ccpe,ctx,wave_available,numberAvailableWaves);
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == QUAL_RANDOM_FIT)
+	else if(WA == QUAL_RANDOM_FIT)
 	{
-		return quality_random_fit(ccpe,ci,wave_available,numberAvailableWaves);
+		return quality_random_fit(ccpe,ctx,wave_available,numberAvailableWaves);
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == QUAL_MOST_USED)
+	else if(WA == QUAL_MOST_USED)
 	{
-		return quality_most_used(ccpe,ci,wave_available,numberAvailableWaves);
+		return quality_most_used(ccpe,ctx,wave_available,numberAvailableWaves);
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == LEAST_QUALITY)
+	else if(WA == LEAST_QUALITY)
 	{
-		return least_quality_fit(ccpe,ci,wave_available);
+		return least_quality_fit(ccpe,ctx,wave_available);
 	}
-	else if(threads[ci]->getCurrentWavelengthAlgorithm() == MOST_QUALITY)
+	else if(WA == MOST_QUALITY)
 	{
-		return most_quality_fit(ccpe,ci,wave_available);
+		return most_quality_fit(ccpe,ctx,wave_available);
 	}
 	else
 	{
-		threadZero->recordEvent("ERROR: Invalid value for CurrentWavelengthAlgorithm.\n",true,ci);
+		threadZero->recordEvent("ERROR: Invalid value for CurrentWavelengthAlgorithm.\n",true,ctx->getControllerIndex());
 		exit(ERROR_CHOOSE_WAVELENGTH_2);
 	}
 
@@ -1486,9 +1345,9 @@ int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigne
 	{
 		q_factor = threadZero->getResourceManager()->estimate_Q(
 			retval,ccpe->connectionPath,ccpe->connectionLength,&xpm_noise,
-			&fwm_noise,&ase_noise,ci);
+			&fwm_noise,&ase_noise,ctx);
 
-		if(threads[ci]->getCurrentQualityAware() == true && 
+		if(QA == true && 
 		   q_factor < threadZero->getQualityParams().TH_Q)
 		{
 			retval = QUALITY_FAILURE;
@@ -1496,11 +1355,43 @@ int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigne
 		}
 	}
 
-	print_connection_info(ccpe,q_factor,ase_noise,fwm_noise,xpm_noise,ci);
+	print_connection_info(ccpe,q_factor,ase_noise,fwm_noise,xpm_noise,ctx);
 
 	return retval;
 }
 
+//Copies of assign_wavelength, by wavelength algorithm and then quality awareness
+#define WAVELENGTH_HANDLERS(wa) { &ResourceManager::assign_wavelength<wa,false>, &ResourceManager::assign_wavelength<wa,true> }
+
+const ResourceManager::WavelengthHandler ResourceManager::wavelengthHandlers[NUMBER_OF_WAVELENGTH_ALGORITHMS][2] = {
+	WAVELENGTH_HANDLERS(FIRST_FIT),
+	WAVELENGTH_HANDLERS(FIRST_FIT_ORDERED),
+	WAVELENGTH_HANDLERS(BEST_FIT),
+	WAVELENGTH_HANDLERS(RANDOM_FIT),
+	WAVELENGTH_HANDLERS(QUAL_FIRST_FIT),
+	WAVELENGTH_HANDLERS(QUAL_FIRST_FIT_ORDERED),
+	WAVELENGTH_HANDLERS(QUAL_RANDOM_FIT),
+	WAVELENGTH_HANDLERS(LEAST_QUALITY),
+	WAVELENGTH_HANDLERS(MOST_QUALITY),
+	WAVELENGTH_HANDLERS(MOST_USED),
+	WAVELENGTH_HANDLERS(QUAL_MOST_USED)
+};
+
+#undef WAVELENGTH_HANDLERS
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	choose_wavelength
+// Description:		Chooses the wavelength of the probe with the
+//					copy of assign_wavelength picked for the job of
+//					the thread.
+//
+///////////////////////////////////////////////////////////////////
+int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx)
+{
+	return (this->*ctx->getThread()->getWavelengthHandler())(ccpe,ctx);
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	estimate_Q
@@ -1508,15 +1399,15 @@ int ResourceManager::choose_wavelength(CreateConnectionProbeEvent* ccpe, unsigne
 //					FWM noise, and ASE noise
 //
 ///////////////////////////////////////////////////////////////////
-double ResourceManager::estimate_Q(short int lambda, Edge **Path, unsigned short int pathLen, double *xpm, double *fwm, double *ase, unsigned short int ci)
+double ResourceManager::estimate_Q(short int lambda, Edge **Path, unsigned short int pathLen, double *xpm, double *fwm, double *ase, SimulationContext* ctx)
 {
 	double noise = 0.0;
 	double Q = 0.0;
 
-	if(lambda >= 0 && lambda < static_cast<int>(threadZero->getNumberOfWavelengths()))
+	if(lambda >= 0 && lambda < static_cast<int>(physical.wavelengths))
 	{
-		*xpm = path_xpm_noise(lambda, Path, pathLen, ci);
-		*fwm = path_fwm_noise(lambda, Path, pathLen, ci);
+		*xpm = path_xpm_noise(lambda, Path, pathLen, ctx);
+		*fwm = path_fwm_noise(lambda, Path, pathLen, ctx);
 	}
 	else
 	{
@@ -1524,22 +1415,352 @@ double ResourceManager::estimate_Q(short int lambda, Edge **Path, unsigned short
 		*fwm = 0.0;
 	}
 
-	*ase = path_ase_noise(lambda, Path, pathLen, ci);
+	*ase = path_ase_noise(lambda, Path, pathLen, ctx);
 
 	noise = *xpm + *fwm + *ase;
   
-	Q = 10.0 * log10(threadZero->getQualityParams().channel_power/sqrt(noise));
+	Q = 10.0 * log10(physical.channel_power/sqrt(noise));
 
 	return Q;
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	estimate_best_Q
+// Description:		Estimates the Q-factor of every wavelength that is
+//					free along the whole path and returns the best one,
+//					or zero when there is no free wavelength.
+//
+///////////////////////////////////////////////////////////////////
+double ResourceManager::estimate_best_Q(Edge **Path, unsigned short int pathLen, SimulationContext* ctx)
+{
+	double spans = 0.0;
+	double bestQ = 0.0;
+
+	for(unsigned short int r = 0; r < pathLen; ++r)
+	{
+		spans += Path[r]->getNumberOfSpans();
+	}
+
+	for(unsigned short int w = 0; w < physical.wavelengths; ++w)
+	{
+		bool free = true;
+
+		for(unsigned short int r = 0; r < pathLen; ++r)
+		{
+			if(Path[r]->getStatus(w) != EDGE_FREE)
+			{
+				free = false;
+				break;
+			}
+		}
+
+		if(free == false)
+			continue;
+
+		double noise = spans * physical.ASE_perEDFA[w] +
+			path_xpm_noise(w, Path, pathLen, ctx) +
+			path_fwm_noise(w, Path, pathLen, ctx);
+
+		double Q = 10.0 * log10(physical.channel_power/sqrt(noise));
+
+		if(Q > bestQ)
+			bestQ = Q;
+	}
+
+	return bestQ;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	estimate_Q_variants
+// Description:		Estimates the Q-factor of every physical parameter
+//					variant from the ASE and the nonlinear noise of
+//					the simulation. The noise only scales with the
+//					parameters, so the path is walked once for all
+//					of the variants.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::estimate_Q_variants(double ase, double nonlinear, float *Q)
+{
+	double noise[MAX_Q_VARIANTS];
+
+	//Every lane is calculated, the unused ones are zero, so the loop vectorizes across the variants
+	for(unsigned short int v = 0; v < MAX_Q_VARIANTS; ++v)
+		noise[v] = physical.variant_ase_scale[v] * ase + physical.variant_nonlinear_scale[v] * nonlinear;
+
+	for(unsigned short int v = 0; v < physical.variants; ++v)
+		Q[v] = float(10.0 * log10(physical.variant_power[v] / sqrt(noise[v])));
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	init_lightpath_noise
+// Description:		Creates the noise accumulators of an established
+//					connection. Every wavelength starts out dirty, so
+//					the first update calculates the whole path.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::init_lightpath_noise(EstablishedConnection* ec)
+{
+	unsigned int xpmRowCount = 2 * physical.nonlinear_halfwin + 1;
+	unsigned int fwmRowCount = static_cast<unsigned int>(fwm_combinations[ec->wavelength].size() / 4);
+
+	ec->xpmRows = new double[xpmRowCount * ec->connectionLength];
+	ec->fwmRows = new double[fwmRowCount * ec->connectionLength];
+	ec->xpmPrefix = new double[ec->connectionLength + 1];
+	ec->fwmPrefix = new double[ec->connectionLength + 1];
+	ec->asePrefix = new double[ec->connectionLength + 1];
+	ec->dirtyWaves = new bool[physical.wavelengths];
+
+	for(unsigned int r = 0; r < xpmRowCount * ec->connectionLength; ++r)
+		ec->xpmRows[r] = 0.0;
+
+	for(unsigned int r = 0; r < fwmRowCount * ec->connectionLength; ++r)
+		ec->fwmRows[r] = 0.0;
+
+	double spans = 0.0;
+
+	ec->xpmPrefix[0] = 0.0;
+	ec->fwmPrefix[0] = 0.0;
+	ec->asePrefix[0] = 0.0;
+
+	for(unsigned short int p = 0; p < ec->connectionLength; ++p)
+	{
+		spans += ec->connectionPath[p]->getNumberOfSpans();
+
+		ec->xpmPrefix[p+1] = 0.0;
+		ec->fwmPrefix[p+1] = 0.0;
+		ec->asePrefix[p+1] = spans * physical.ASE_perEDFA[ec->wavelength];
+	}
+
+	for(unsigned short int w = 0; w < physical.wavelengths; ++w)
+		ec->dirtyWaves[w] = true;
+
+	ec->dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	update_lightpath_noise
+// Description:		Brings the noise accumulators of an established
+//					connection up to date. Only the XPM rows of the
+//					wavelengths that changed on the path and the FWM
+//					combinations that use them are recalculated, the
+//					prefix sums are adjusted by the difference.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::update_lightpath_noise(EstablishedConnection* ec, SimulationContext* ctx)
+{
+	if(ec->dirty == false)
+		return;
+
+	int halfwin = physical.nonlinear_halfwin;
+	int lambda = ec->wavelength;
+
+	int first = lambda - halfwin;
+	int last = lambda + halfwin;
+
+	if(first < 0)
+		first = 0;
+
+	if(last >= static_cast<int>(physical.wavelengths))
+		last = physical.wavelengths - 1;
+
+	for(int wave = first; wave <= last; ++wave)
+	{
+		if(ec->dirtyWaves[wave] == true && wave != lambda)
+		{
+			lightpath_xpm_row(ec, wave,
+				&ec->xpmRows[(wave - lambda + halfwin) * ec->connectionLength], ec->xpmPrefix, ctx);
+		}
+	}
+
+	for(unsigned int r = 0; r < fwm_combinations[lambda].size() / 4; ++r)
+	{
+		int i_wave = (*inter_indecies)[lambda][fwm_combinations[lambda][r * 4 + 0]];
+		int j_wave = (*inter_indecies)[lambda][fwm_combinations[lambda][r * 4 + 1]];
+		int k_wave = (*inter_indecies)[lambda][fwm_combinations[lambda][r * 4 + 2]];
+
+		if(ec->dirtyWaves[i_wave] == true || ec->dirtyWaves[j_wave] == true || ec->dirtyWaves[k_wave] == true)
+		{
+			lightpath_fwm_row(ec, r, &ec->fwmRows[r * ec->connectionLength], ec->fwmPrefix, ctx);
+		}
+	}
+
+	for(int wave = first; wave <= last; ++wave)
+		ec->dirtyWaves[wave] = false;
+
+	ec->dirty = false;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	free_lightpath_noise
+// Description:		Deletes the noise accumulators of an established
+//					connection.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::free_lightpath_noise(EstablishedConnection* ec)
+{
+	delete[] ec->xpmRows;
+	delete[] ec->fwmRows;
+	delete[] ec->xpmPrefix;
+	delete[] ec->fwmPrefix;
+	delete[] ec->asePrefix;
+	delete[] ec->dirtyWaves;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	lightpath_noise
+// Description:		Returns the noise of the first hops of an
+//					established connection. The accumulators must
+//					be up to date.
+//
+///////////////////////////////////////////////////////////////////
+double ResourceManager::lightpath_noise(EstablishedConnection* ec, unsigned short int hops)
+{
+	return ec->xpmPrefix[hops] +
+		physical.fwm_scale * ec->fwmPrefix[hops] +
+		ec->asePrefix[hops];
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	lightpath_Q_variants
+// Description:		Returns the Q-factor of every physical parameter
+//					variant of an established connection.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::lightpath_Q_variants(EstablishedConnection* ec, float *Q)
+{
+	estimate_Q_variants(ec->asePrefix[ec->connectionLength],
+		ec->xpmPrefix[ec->connectionLength] + physical.fwm_scale * ec->fwmPrefix[ec->connectionLength], Q);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	lightpath_xpm_row
+// Description:		Recalculates the XPM that one wavelength causes
+//					on every prefix of an established connection, in
+//					the same way as path_xpm_noise.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::lightpath_xpm_row(EstablishedConnection* ec, short int wave, double *row, double *prefix, SimulationContext* ctx)
+{
+	Edge **Path = ec->connectionPath;
+
+	//Rows of the link state of the thread, one for every edge of the path
+	const int **state = ctx->getLinkStateRows();
+
+	for(unsigned short int j = 0; j < ec->connectionLength; ++j)
+		state[j] = Path[j]->getLinkState();
+
+	double completed = 0.0;
+	int path_len = 0;
+
+	for(unsigned short int j = 0; j < ec->connectionLength; ++j)
+	{
+		if(state[j][wave] != LINK_STATE_FREE)
+		{
+			//A different session on the previous link starts a new segment.
+			if(path_len > 0 && state[j-1][wave] != state[j][wave])
+			{
+				completed += path_xpm_term(path_len, ec->wavelength, wave);
+				path_len = 0;
+			}
+
+			path_len += Path[j]->getNumberOfSpans();
+		}
+		else if(path_len > 0)
+		{
+			completed += path_xpm_term(path_len, ec->wavelength, wave);
+			path_len = 0;
+		}
+
+		double noise = completed;
+
+		if(path_len > 0)
+			noise += path_xpm_term(path_len, ec->wavelength, wave);
+
+		prefix[j+1] += noise - row[j];
+		row[j] = noise;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	lightpath_fwm_row
+// Description:		Recalculates the FWM that one combination causes
+//					on every prefix of an established connection, in
+//					the same way as path_fwm_noise.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::lightpath_fwm_row(EstablishedConnection* ec, unsigned int r, double *row, double *prefix, SimulationContext* ctx)
+{
+	Edge **Path = ec->connectionPath;
+	int lambda = ec->wavelength;
+
+	//Rows of the link state of the thread, one for every edge of the path
+	const int **state = ctx->getLinkStateRows();
+
+	for(unsigned short int j = 0; j < ec->connectionLength; ++j)
+		state[j] = Path[j]->getLinkState();
+
+	int i_id = fwm_combinations[lambda][r * 4 + 0];
+	int j_id = fwm_combinations[lambda][r * 4 + 1];
+	int k_id = fwm_combinations[lambda][r * 4 + 2];
+	const FWMTerm &term = fwm_terms[lambda][r];
+
+	int i_wave = (*inter_indecies)[lambda][i_id];
+	int j_wave = (*inter_indecies)[lambda][j_id];
+	int k_wave = (*inter_indecies)[lambda][k_id];
+
+	double completed = 0.0;
+	unsigned short int plen = 0;
+
+	for(unsigned short int j = 0; j < ec->connectionLength; ++j)
+	{
+		if((state[j][i_wave] != LINK_STATE_FREE || i_wave == lambda) &&
+		   (state[j][j_wave] != LINK_STATE_FREE || j_wave == lambda) &&
+		   (state[j][k_wave] != LINK_STATE_FREE || k_wave == lambda))
+		{
+			//A different session on the previous link starts a new segment.
+			if(plen > 0 &&
+				(state[j-1][i_wave] != state[j][i_wave] ||
+				state[j-1][j_wave] != state[j][j_wave] ||
+				state[j-1][k_wave] != state[j][k_wave]))
+			{
+				completed += path_fwm_term(plen,term);
+				plen = 0;
+			}
+
+			plen += Path[j]->getNumberOfSpans();
+		}
+		else if(plen > 0)
+		{
+			completed += path_fwm_term(plen,term);
+			plen = 0;
+		}
+
+		double noise = completed;
+
+		if(plen > 0)
+			noise += path_fwm_term(plen,term);
+
+		prefix[j+1] += noise - row[j];
+		row[j] = noise;
+	}
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	path_ase_noise
 // Description:		Calculates the ASE noise created along the path.
 //
 ///////////////////////////////////////////////////////////////////
-double ResourceManager::path_ase_noise(short int lambda, Edge **Path, unsigned short int pathLen, unsigned short int ci)
+double ResourceManager::path_ase_noise(short int lambda, Edge **Path, unsigned short int pathLen, SimulationContext* ctx)
 {
 	double spans = 0.0;
 	
@@ -1548,7 +1769,7 @@ double ResourceManager::path_ase_noise(short int lambda, Edge **Path, unsigned s
 		spans += Path[r]->getNumberOfSpans();
 	}
 
-	return spans * threadZero->getQualityParams().ASE_perEDFA[lambda];
+	return spans * physical.ASE_perEDFA[lambda];
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -1557,15 +1778,21 @@ double ResourceManager::path_ase_noise(short int lambda, Edge **Path, unsigned s
 // Description:		Calculates the ASE noise created along the path.
 //
 ///////////////////////////////////////////////////////////////////
-double ResourceManager::path_xpm_noise(short int lambda, Edge **Path, unsigned short int pathLen, unsigned short int ci)
+double ResourceManager::path_xpm_noise(short int lambda, Edge **Path, unsigned short int pathLen, SimulationContext* ctx)
 {
  	double noise = 0.0;  
 
-	for(int wave = 0; wave < static_cast<int>(threadZero->getNumberOfWavelengths()); ++wave)
+	//Rows of the link state of the thread, one for every edge of the path
+	const int **state = ctx->getLinkStateRows();
+
+	for(unsigned short int j = 0; j < pathLen; ++j)
+		state[j] = Path[j]->getLinkState();
+
+	for(int wave = 0; wave < static_cast<int>(physical.wavelengths); ++wave)
 	{
 		//We don't want to compute the XPM for cases where the wavelength is outside of the halfwin window
 		//or where the wavelength is equal to the connection wavelength.
-		if ((abs(wave - lambda) > threadZero->getQualityParams().nonlinear_halfwin) || wave == lambda) 
+		if ((abs(wave - lambda) > physical.nonlinear_halfwin) || wave == lambda) 
 			continue;
 
 		unsigned short int index = 0; 
@@ -1577,7 +1804,7 @@ double ResourceManager::path_xpm_noise(short int lambda, Edge **Path, unsigned s
 
 			for(j = index; j < pathLen; ++j)
 			{
-				if(Path[j]->getStatus(wave) == EDGE_USED)
+				if(state[j][wave] != LINK_STATE_FREE)
 				{
 					//If the cumulative path length is zero, then we don't care about the session.
 					if(path_len == 0)
@@ -1586,7 +1813,7 @@ double ResourceManager::path_xpm_noise(short int lambda, Edge **Path, unsigned s
 					}
 					//If the path_len is greater than zero, then we need to make sure that the session number is
 					//equal to the previous session.
-					else if(Path[j-1]->getActiveSession(wave) == Path[j]->getActiveSession(wave))
+					else if(state[j-1][wave] == state[j][wave])
 					{
 						path_len += Path[j]->getNumberOfSpans();
 					}
@@ -1627,7 +1854,7 @@ double ResourceManager::path_xpm_noise(short int lambda, Edge **Path, unsigned s
 ///////////////////////////////////////////////////////////////////
 double ResourceManager::path_xpm_term(short int spans, short int lambda, short int wave)
 {
-	return sys_link_xpm_database[lambda * threadZero->getNumberOfWavelengths() + wave] * double(spans) * double(spans);
+	return sys_link_xpm_database[lambda * physical.wavelengths + wave] * double(spans) * double(spans);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -1636,23 +1863,26 @@ double ResourceManager::path_xpm_term(short int spans, short int lambda, short i
 // Description:      Calculates the ASE noise created along the path.
 //
 ///////////////////////////////////////////////////////////////////
-double ResourceManager::path_fwm_noise(short int lambda, Edge **Path, unsigned short int pathLen, unsigned short int ci)
+double ResourceManager::path_fwm_noise(short int lambda, Edge **Path, unsigned short int pathLen, SimulationContext* ctx)
 {
     double noise = 0.0;
 
+	//Rows of the link state of the thread, one for every edge of the path
+	const int **state = ctx->getLinkStateRows();
+
+	for(unsigned short int j = 0; j < pathLen; ++j)
+		state[j] = Path[j]->getLinkState();
+
 	for(int r = 0; r < static_cast<int>(fwm_combinations[lambda].size() / 4); r++)
     {
         int i_id = fwm_combinations[lambda][r * 4 + 0];
         int j_id = fwm_combinations[lambda][r * 4 + 1];
         int k_id = fwm_combinations[lambda][r * 4 + 2];
-        int d = fwm_combinations[lambda][r * 4 + 3];
+        const FWMTerm &term = fwm_terms[lambda][r];
 
 		int i_wave = (*inter_indecies)[lambda][i_id];
         int j_wave = (*inter_indecies)[lambda][j_id];
         int k_wave = (*inter_indecies)[lambda][k_id];
-        double fi = (*fwm_fs)[lambda][i_id];
-        double fj = (*fwm_fs)[lambda][j_id];
-        double fk = (*fwm_fs)[lambda][k_id];       
 
         unsigned short int index = 0;
         unsigned short int plen = 0;
@@ -1662,9 +1892,9 @@ double ResourceManager::path_fwm_noise(short int lambda, Edge **Path, unsigned s
 	    {
 		    for(j = index; j < pathLen; ++j)
 			{
-				if((Path[j]->getStatus(i_wave) == EDGE_USED || i_wave == lambda) &&
-	               (Path[j]->getStatus(j_wave) == EDGE_USED || j_wave == lambda) &&
-	               (Path[j]->getStatus(k_wave) == EDGE_USED || k_wave == lambda))
+				if((state[j][i_wave] != LINK_STATE_FREE || i_wave == lambda) &&
+	               (state[j][j_wave] != LINK_STATE_FREE || j_wave == lambda) &&
+	               (state[j][k_wave] != LINK_STATE_FREE || k_wave == lambda))
 				{
 					//If the cumulative path length is zero, then we don't care about the session.
 					if(plen == 0)
@@ -1673,9 +1903,9 @@ double ResourceManager::path_fwm_noise(short int lambda, Edge **Path, unsigned s
 					}
 					//If the path_len is greater than zero, then we need to make sure that the session numbers are
 					//equal to the previous session.
-					else if(Path[j-1]->getActiveSession(i_wave) == Path[j]->getActiveSession(i_wave) &&
-							Path[j-1]->getActiveSession(j_wave) == Path[j]->getActiveSession(j_wave) &&
-							Path[j-1]->getActiveSession(k_wave) == Path[j]->getActiveSession(k_wave))
+					else if(state[j-1][i_wave] == state[j][i_wave] &&
+							state[j-1][j_wave] == state[j][j_wave] &&
+							state[j-1][k_wave] == state[j][k_wave])
 					{
 						plen += Path[j]->getNumberOfSpans();
 					}
@@ -1696,7 +1926,7 @@ double ResourceManager::path_fwm_noise(short int lambda, Edge **Path, unsigned s
         
 			if(plen > 0)
 			{
-				noise += path_fwm_term(plen,fi,fj,fk,sys_fs[lambda],d);
+				noise += path_fwm_term(plen,term);
 			}
 			else if(plen == 0)
 			{
@@ -1707,7 +1937,70 @@ double ResourceManager::path_fwm_noise(short int lambda, Edge **Path, unsigned s
 		}//end while     
     } //end for
   
-    return 2.0 * threadZero->getQualityParams().channel_power * noise;
+    return physical.fwm_scale * noise;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	build_physical_parameters
+// Description:		Copies the quality parameters used by the Q-factor
+//					calculations into the physical parameter block and
+//					calculates the constants derived from them.
+//
+///////////////////////////////////////////////////////////////////
+void ResourceManager::build_physical_parameters()
+{
+	const QualityParameters &qp = threadZero->getQualityParams();
+
+	double c = 2.99792457778e+8;
+
+	physical.channel_power = qp.channel_power;
+	physical.fwm_scale = 2.0 * qp.channel_power;
+	physical.alpha = qp.alpha;
+	physical.alpha_square = physical.alpha * physical.alpha;
+	physical.L = qp.L;
+	physical.alphaL = physical.alpha * physical.L;
+	physical.exp_alphaL = exp(-physical.alphaL);
+	physical.exp_2alphaL = exp(-2.0 * physical.alphaL);
+	physical.D = qp.D;
+	physical.S = qp.S;
+	physical.gamma = qp.gamma;
+	physical.ASE_perEDFA = qp.ASE_perEDFA;
+	physical.nonlinear_halfwin = qp.nonlinear_halfwin;
+	physical.halfwavelength = qp.halfwavelength;
+	physical.wavelengths = threadZero->getNumberOfWavelengths();
+
+	physical.lambdac = new double[physical.wavelengths];
+
+	for(unsigned short int w = 0; w < physical.wavelengths; ++w)
+		physical.lambdac[w] = c / sys_fs[w];
+
+	physical.variants = qp.Q_variants;
+
+	for(unsigned short int v = 0; v < MAX_Q_VARIANTS; ++v)
+	{
+		physical.variant_power[v] = 0.0;
+		physical.variant_ase_scale[v] = 0.0;
+		physical.variant_nonlinear_scale[v] = 0.0;
+		physical.variant_TH_Q[v] = 0.0;
+	}
+
+	for(unsigned short int v = 0; v < physical.variants; ++v)
+	{
+		double power = qp.Q_variant_power[v] / qp.channel_power;
+		double gamma = qp.Q_variant_gamma[v] / qp.gamma;
+
+		physical.variant_power[v] = qp.Q_variant_power[v];
+
+		//The ASE grows with the power and the noise figure, the XPM and FWM with
+		//the power of the channel times the cube of the power of the others and
+		//with the square of gamma.
+		physical.variant_ase_scale[v] = power * pow(10.0,(qp.Q_variant_noise_figure[v] - qp.EDFA_Noise_Figure) / 10.0);
+		physical.variant_nonlinear_scale[v] = power * power * power * power * gamma * gamma;
+
+		//Same factor of the max min Q-factor as the threshold of the simulation
+		physical.variant_TH_Q[v] = qp.TH_Q + qp.QFactor_factor * 10.0 * log10(power / sqrt(physical.variant_ase_scale[v]));
+	}
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -1973,25 +2266,26 @@ int ResourceManager::degeneracy(int fi,int fj,int fk)
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	path_fwm_term
-// Description: 
+// Function Name:	build_fwm_term
+// Description:		Calculates the part of the FWM noise of one
+//					combination that does not depend on the number
+//					of spans, so path_fwm_term only has one cosine
+//					left to evaluate.
 //
 ///////////////////////////////////////////////////////////////////
-double ResourceManager::path_fwm_term(int spans,double fi,double fj, double fk,double fc,int dgen)
+void ResourceManager::build_fwm_term(double fi,double fj, double fk,unsigned short int lambda,int dgen,FWMTerm &term)
 { 
 	double c = 2.99792457778e+8;
 	double pi = 3.14159265358979323846;
-	double lambdac = c / fc;
-	double noise = 0.0;   
-	double wdm_factor = 0.0;
+	double fc = sys_fs[lambda];
+	double lambdac = physical.lambdac[lambda];
 	double Pi_0, Pj_0, Pk_0;
 
-	double alpha = threadZero->getQualityParams().alpha;
-	double channel_power = threadZero->getQualityParams().channel_power;
-	double D = threadZero->getQualityParams().D;
-	double S = threadZero->getQualityParams().S;
-	double L = threadZero->getQualityParams().L;
-	double gamma = threadZero->getQualityParams().gamma;
+	double channel_power = physical.channel_power;
+	double D = physical.D;
+	double S = physical.S;
+	double L = physical.L;
+	double gamma = physical.gamma;
        
 	if (fi==fc)
 		Pi_0 = channel_power;
@@ -2010,15 +2304,34 @@ double ResourceManager::path_fwm_term(int spans,double fi,double fj, double fk,d
    
 	double diff_kappa = 2.0 * pi * lambdac * lambdac / c * (fi - fc) * (fj - fc) * (D - lambdac * lambdac / c * (fi / 2.0 + fj / 2.0 - fc ) * S); 
 	double diff_phi = 2.0 * pi * lambdac * lambdac / c * (fi - fc) * (fj - fc) * (-lambdac * lambdac / c * (fi / 2.0 + fj / 2.0 - fc) * S) * L;
-	double Leff_square = (1.0 + exp(-2.0 * alpha * L) -  2.0 * exp(-alpha * L) * cos(diff_kappa * L) ) / (alpha * alpha + diff_kappa * diff_kappa);
-	double tmp = gamma * gamma * dgen * dgen / 9.0 * Pi_0 * Pj_0 * Pk_0 * Leff_square;
+	double Leff_square = (1.0 + physical.exp_2alphaL -  2.0 * physical.exp_alphaL * cos(diff_kappa * L) ) / (physical.alpha_square + diff_kappa * diff_kappa);
+
+	term.coefficient = gamma * gamma * dgen * dgen / 9.0 * Pi_0 * Pj_0 * Pk_0 * Leff_square;
+	term.phi = diff_phi;
+
+	if (cos(diff_phi) != 1)
+		term.denominator = double(1.0) - cos(diff_phi);
+	else
+		term.denominator = 0.0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	path_fwm_term
+// Description:		Calculates the FWM noise of one combination over
+//					a number of spans.
+//
+///////////////////////////////////////////////////////////////////
+double ResourceManager::path_fwm_term(int spans, const FWMTerm &term)
+{ 
+	double wdm_factor = 0.0;
 
-    if (cos(diff_phi) != 1)
-		wdm_factor = (double(1.0)-cos(diff_phi*spans)) /(double(1.0)-cos(diff_phi));
+    if (term.denominator != 0.0)
+		wdm_factor = (double(1.0)-cos(term.phi*spans)) / term.denominator;
     else 
 		wdm_factor  =  double(spans * spans);
            
-    return tmp * wdm_factor;
+    return term.coefficient * wdm_factor;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -2028,7 +2341,7 @@ double ResourceManager::path_fwm_term(int spans,double fi,double fj, double fk,d
 //					algorithm
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::first_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available)
+int ResourceManager::first_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available)
 {
 	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
@@ -2047,13 +2360,8 @@ int ResourceManager::first_fit(CreateConnectionProbeEvent* ccpe, unsigned short
 //					with_ordering_algorithm
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available)
+int ResourceManager::first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available)
 {
-	if(wave_ordering == 0)
-	{
-		generateWaveOrdering();
-	}
-
 	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
 		if(wave_available[wave_ordering[w]] == true)
@@ -2071,7 +2379,7 @@ int ResourceManager::first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, u
 //					with_ordering_algorithm
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::most_used(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available)
+int ResourceManager::most_used(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available)
 {
 	int *wave_counts = new int[threadZero->getNumberOfWavelengths()];
 
@@ -2082,9 +2390,9 @@ int ResourceManager::most_used(CreateConnectionProbeEvent* ccpe, unsigned short
 
 	for(unsigned int r = 0; r < threadZero->getNumberOfRouters(); ++r)
 	{
-		for(unsigned int e = 0; e < threads[ci]->getRouterAt(r)->getNumberOfEdges(); ++e)
+		for(unsigned int e = 0; e < ctx->getThread()->getRouterAt(r)->getNumberOfEdges(); ++e)
 		{
-			Edge *edge = threads[ci]->getRouterAt(r)->getEdgeByIndex(e);
+			Edge *edge = ctx->getThread()->getRouterAt(r)->getEdgeByIndex(e);
 
 			for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 			{
@@ -2123,14 +2431,13 @@ int ResourceManager::most_used(CreateConnectionProbeEvent* ccpe, unsigned short
 //					algorithm
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::random_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available, unsigned short int numberAvailableWaves)
+int ResourceManager::random_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available, unsigned short int numberAvailableWaves)
 {
-	boost::mt19937 rng;
-	rng.seed(boost::uint32_t(threadZero->getRandomSeed() * ccpe->sourceRouterIndex * ccpe->destinationRouterIndex * numberAvailableWaves));
-	boost::uniform_int<> wk(0,numberAvailableWaves - 1);
-	boost::variate_generator<boost::mt19937&, boost::uniform_int<> > generateWavelength(rng, wk);
+	boost::uint32_t block[RANDOM_BLOCK_SIZE];
+	CounterRandom::generateBlock(CounterRandom::makeKey(ctx->getThread()->getRandomSeed(),ccpe->sourceRouterIndex),
+		ccpe->session,RANDOM_WAVELENGTH,ccpe->sequence,(boost::uint32_t(ccpe->destinationRouterIndex) << 16) | numberAvailableWaves,block);
 
-	unsigned short int waveToReturn = generateWavelength();
+	unsigned short int waveToReturn = static_cast<unsigned short int>(CounterRandom::toZeroToOne(block[0]) * numberAvailableWaves);
 	unsigned short int waveIndex = 0;
 
 	for(unsigned short int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
@@ -2148,7 +2455,7 @@ int ResourceManager::random_fit(CreateConnectionProbeEvent* ccpe, unsigned short
 		}
 	}
 
-	threadZero->recordEvent("ERROR: Unexpected point in choose wavelength.\n",true,ci);
+	threadZero->recordEvent("ERROR: Unexpected point in choose wavelength.\n",true,ctx->getControllerIndex());
 	exit(ERROR_CHOOSE_WAVELENGTH_1);
 }
 
@@ -2159,7 +2466,7 @@ int ResourceManager::random_fit(CreateConnectionProbeEvent* ccpe, unsigned short
 //					algorithm using quality
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::quality_first_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves)
+int ResourceManager::quality_first_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves)
 {
 	while(numberAvailableWaves > 0)
 	{
@@ -2168,15 +2475,15 @@ int ResourceManager::quality_first_fit(CreateConnectionProbeEvent* ccpe, unsigne
 		double ase = 0.0; 
 		double Q_factor = 0.0;
 
-		int wave = first_fit(ccpe,ci,wave_available);
+		int wave = first_fit(ccpe,ctx,wave_available);
 
-		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci);
+		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx);
 
 		if(threadZero->getQualityParams().TH_Q <= Q_factor)
 		{
 			ccpe->wavelength = wave;
 
-			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ci);
+			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ctx);
 
 			delete[] wave_available;
 			return wave;
@@ -2192,7 +2499,7 @@ int ResourceManager::quality_first_fit(CreateConnectionProbeEvent* ccpe, unsigne
 
 	ccpe->wavelength = QUALITY_FAILURE;
 
-	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ci);
+	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ctx);
 
 	return QUALITY_FAILURE;
 }
@@ -2204,7 +2511,7 @@ int ResourceManager::quality_first_fit(CreateConnectionProbeEvent* ccpe, unsigne
 //					algorithm using quality
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::quality_first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves)
+int ResourceManager::quality_first_fit_with_ordering(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves)
 {
 	while(numberAvailableWaves > 0)
 	{
@@ -2213,15 +2520,15 @@ int ResourceManager::quality_first_fit_with_ordering(CreateConnectionProbeEvent*
 		double ase = 0.0; 
 		double Q_factor = 0.0;
 
-		int wave = first_fit_with_ordering(ccpe,ci,wave_available);
+		int wave = first_fit_with_ordering(ccpe,ctx,wave_available);
 
-		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci);
+		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx);
 
 		if(threadZero->getQualityParams().TH_Q <= Q_factor)
 		{
 			ccpe->wavelength = wave;
 
-			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ci);
+			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ctx);
 
 			delete[] wave_available;
 			return wave;
@@ -2237,7 +2544,7 @@ int ResourceManager::quality_first_fit_with_ordering(CreateConnectionProbeEvent*
 
 	ccpe->wavelength = QUALITY_FAILURE;
 
-	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ci);
+	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ctx);
 
 	return QUALITY_FAILURE;
 }
@@ -2249,7 +2556,7 @@ int ResourceManager::quality_first_fit_with_ordering(CreateConnectionProbeEvent*
 //					fit algorithm using quality
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::least_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available)
+int ResourceManager::least_quality_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available)
 {
 	int minQualityWave = -1;
 	double minQualityQFactor = std::numeric_limits<float>::infinity();
@@ -2258,6 +2565,11 @@ int ResourceManager::least_quality_fit(CreateConnectionProbeEvent* ccpe, unsigne
 	double minFWM = 0.0;
 	double minASE = 0.0;
 
+	QualityPool* pool = ctx->getThread()->getQualityPool();
+
+	if(pool != 0)
+		pool->evaluate(ccpe->connectionPath,ccpe->connectionLength,wave_available,ctx);
+
 	for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
 		if(wave_available[w] == true)
@@ -2268,7 +2580,10 @@ int ResourceManager::least_quality_fit(CreateConnectionProbeEvent* ccpe, unsigne
 			double fwm = 0.0;
 			double ase = 0.0;
 
-			qfactor = threadZero->getResourceManager()->estimate_Q(w,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci);
+			if(pool != 0)
+				qfactor = pool->getQ(w,&xpm,&fwm,&ase);
+			else
+				qfactor = threadZero->getResourceManager()->estimate_Q(w,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx);
 
 			if(qfactor < minQualityQFactor && qfactor >= threadZero->getQualityParams().TH_Q)
 			{
@@ -2288,13 +2603,13 @@ int ResourceManager::least_quality_fit(CreateConnectionProbeEvent* ccpe, unsigne
 	{
 		ccpe->wavelength = QUALITY_FAILURE;
 
-		print_connection_info(ccpe,0.0,0.0,0.0,0.0,ci);
+		print_connection_info(ccpe,0.0,0.0,0.0,0.0,ctx);
 	}
 	else
 	{
 		ccpe->wavelength = minQualityWave;
 
-		print_connection_info(ccpe,minQualityQFactor,minASE,minFWM,minXPM,ci);
+		print_connection_info(ccpe,minQualityQFactor,minASE,minFWM,minXPM,ctx);
 	}
 
 	return ccpe->wavelength;
@@ -2307,7 +2622,7 @@ int ResourceManager::least_quality_fit(CreateConnectionProbeEvent* ccpe, unsigne
 //					fit algorithm using quality
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::most_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available)
+int ResourceManager::most_quality_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available)
 {
 	int maxQualityWave = -1;
 	double maxQualityQFactor = 0.0;
@@ -2316,6 +2631,11 @@ int ResourceManager::most_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned
 	double maxFWM = 0.0;
 	double maxASE = 0.0;
 
+	QualityPool* pool = ctx->getThread()->getQualityPool();
+
+	if(pool != 0)
+		pool->evaluate(ccpe->connectionPath,ccpe->connectionLength,wave_available,ctx);
+
 	for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
 		if(wave_available[w] == true)
@@ -2326,7 +2646,10 @@ int ResourceManager::most_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned
 			double fwm = 0.0;
 			double ase = 0.0;
 
-			qfactor = threadZero->getResourceManager()->estimate_Q(w,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci);
+			if(pool != 0)
+				qfactor = pool->getQ(w,&xpm,&fwm,&ase);
+			else
+				qfactor = threadZero->getResourceManager()->estimate_Q(w,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx);
 
 			if(qfactor > maxQualityQFactor && qfactor >= threadZero->getQualityParams().TH_Q)
 			{
@@ -2346,13 +2669,13 @@ int ResourceManager::most_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned
 	{
 		ccpe->wavelength = QUALITY_FAILURE;
 
-		print_connection_info(ccpe,0.0,0.0,0.0,0.0,ci);
+		print_connection_info(ccpe,0.0,0.0,0.0,0.0,ctx);
 	}
 	else
 	{
 		ccpe->wavelength = maxQualityWave;
 
-		print_connection_info(ccpe,maxQualityQFactor,maxASE,maxFWM,maxXPM,ci);
+		print_connection_info(ccpe,maxQualityQFactor,maxASE,maxFWM,maxXPM,ctx);
 	}
 
 	return ccpe->wavelength;
@@ -2365,7 +2688,7 @@ int ResourceManager::most_quality_fit(CreateConnectionProbeEvent* ccpe, unsigned
 //					algorithm using quality
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::quality_random_fit(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves)
+int ResourceManager::quality_random_fit(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves)
 {
 	while(numberAvailableWaves > 0)
 	{
@@ -2374,16 +2697,16 @@ int ResourceManager::quality_random_fit(CreateConnectionProbeEvent* ccpe, unsign
 		double ase = 0.0;
 		double Q_factor = 0.0;
 
-		int wave = random_fit(ccpe,ci,wave_available,numberAvailableWaves);
+		int wave = random_fit(ccpe,ctx,wave_available,numberAvailableWaves);
 
-		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci);
+		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx);
 
 		if(threadZero->getQualityParams().TH_Q <=
-		   threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci))
+		   threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx))
 		{
 			ccpe->wavelength = wave;
 
-			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ci);
+			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ctx);
 
 			delete[] wave_available;
 			return wave;
@@ -2399,7 +2722,7 @@ int ResourceManager::quality_random_fit(CreateConnectionProbeEvent* ccpe, unsign
 
 	ccpe->wavelength = QUALITY_FAILURE;
 
-	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ci);
+	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ctx);
 
 	return QUALITY_FAILURE;
 }
@@ -2411,7 +2734,7 @@ int ResourceManager::quality_random_fit(CreateConnectionProbeEvent* ccpe, unsign
 //					algorithm using quality
 //
 ///////////////////////////////////////////////////////////////////
-int ResourceManager::quality_most_used(CreateConnectionProbeEvent* ccpe, unsigned short int ci, bool* wave_available,unsigned short int numberAvailableWaves)
+int ResourceManager::quality_most_used(CreateConnectionProbeEvent* ccpe, SimulationContext* ctx, bool* wave_available,unsigned short int numberAvailableWaves)
 {
 	while(numberAvailableWaves > 0)
 	{
@@ -2420,15 +2743,15 @@ int ResourceManager::quality_most_used(CreateConnectionProbeEvent* ccpe, unsigne
 		double ase = 0.0;
 		double Q_factor = 0.0;
 
-		int wave = most_used(ccpe,ci,wave_available);
+		int wave = most_used(ccpe,ctx,wave_available);
 
-		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ci);
+		Q_factor = threadZero->getResourceManager()->estimate_Q(wave,ccpe->connectionPath,ccpe->connectionLength,&xpm,&fwm,&ase,ctx);
 
 		if(threadZero->getQualityParams().TH_Q <= Q_factor)
 		{
 			ccpe->wavelength = wave;
 
-			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ci);
+			print_connection_info(ccpe,Q_factor,ase,fwm,xpm,ctx);
 
 			delete[] wave_available;
 			return wave;
@@ -2444,7 +2767,7 @@ int ResourceManager::quality_most_used(CreateConnectionProbeEvent* ccpe, unsigne
 
 	ccpe->wavelength = QUALITY_FAILURE;
 
-	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ci);
+	print_connection_info(ccpe,0.0,0.0,0.0,0.0,ctx);
 
 	return QUALITY_FAILURE;
 }
@@ -2485,60 +2808,62 @@ void ResourceManager::precompute_fwm_combinations()
 	precompute_fwm_fs(fwm_nums);
 
 	fwm_combinations = new vector<int>[threadZero->getNumberOfWavelengths()];
+	fwm_terms = new vector<FWMTerm>[threadZero->getNumberOfWavelengths()];
 
 	for(int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
 		wave_combines(sys_fs[w],(*fwm_fs)[w],fwm_nums[w],fwm_combinations[w]);
+
+		fwm_terms[w].resize(fwm_combinations[w].size() / 4);
+
+		build_fwm_terms(w);
 	}
 }
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	initSPMatrix
-// Description:		Initializes the SP matrix so that the paths
-//					can be stored.
+// Function Name:	build_fwm_terms
+// Description:		Calculates the FWMTerm of every combination of
+//					a wavelength from the physical parameters.
 //
 ///////////////////////////////////////////////////////////////////
-void ResourceManager::initSPMatrix()
+void ResourceManager::build_fwm_terms(int w)
 {
-	if(SP_paths != 0)
-		return;
-
-	SP_paths = new kShortestPathReturn*[threadZero->getNumberOfRouters() * threadZero->getNumberOfRouters()];
-
-	for(unsigned short int p = 0; p < threadZero->getNumberOfRouters() * threadZero->getNumberOfRouters(); ++p)
+	for(unsigned int r = 0; r < fwm_terms[w].size(); ++r)
 	{
-		SP_paths[p] = 0;
+		build_fwm_term((*fwm_fs)[w][fwm_combinations[w][r * 4 + 0]],
+			(*fwm_fs)[w][fwm_combinations[w][r * 4 + 1]],
+			(*fwm_fs)[w][fwm_combinations[w][r * 4 + 2]],
+			w,fwm_combinations[w][r * 4 + 3],fwm_terms[w][r]);
 	}
 }
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	freeSPMatrix
-// Description:		Free the SP matrix so that the memory can be
-//					reused.
+// Function Name:	free_fwm_combinations
+// Description:		Frees the combinations that cause FWM and their
+//					FWMTerms.
 //
 ///////////////////////////////////////////////////////////////////
-void ResourceManager::freeSPMatrix()
+void ResourceManager::free_fwm_combinations()
 {
-	if(SP_paths == 0)
-		return;
+	for(unsigned int s = 0; s < fwm_combinations->size(); ++s)
+		fwm_combinations[s].clear();
 
-	for(unsigned short int p = 0; p < threadZero->getNumberOfRouters() * threadZero->getNumberOfRouters(); ++p)
+	for(unsigned int w = 0; w < threadZero->getNumberOfWavelengths(); ++w)
 	{
-		if(SP_paths[p] != 0)
-		{
-			delete[] SP_paths[p]->pathcost;
-			delete[] SP_paths[p]->pathinfo;
-			delete[] SP_paths[p]->pathlen;
-
-			delete SP_paths[p];
-		}
+		delete[] (*fwm_fs)[w];
+		delete[] (*inter_indecies)[w];
 	}
+	
+	fwm_fs->clear();
+	inter_indecies->clear();
 
-	delete[] SP_paths;
+	delete[] fwm_combinations;
+	delete[] fwm_terms;
 
-	SP_paths = 0;
+	delete[] fwm_fs;
+	delete[] inter_indecies;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -2585,7 +2910,7 @@ void ResourceManager::build_KSP_EdgeList()
 // Description:		Prints the information about the connection
 //
 ///////////////////////////////////////////////////////////////////
-void ResourceManager::print_connection_info(CreateConnectionProbeEvent* ccpe, double Q_factor, double ase, double fwm, double xpm, unsigned short int ci)
+void ResourceManager::print_connection_info(CreateConnectionProbeEvent* ccpe, double Q_factor, double ase, double fwm, double xpm, SimulationContext* ctx)
 {
 	string line;
 	char buffer[200];
@@ -2625,13 +2950,13 @@ void ResourceManager::print_connection_info(CreateConnectionProbeEvent* ccpe, do
 		line.append("\n");
 	}
 
-	threadZero->recordEvent(line,false,ci);
+	threadZero->recordEvent(line,false,ctx->getControllerIndex());
 
 	if(ccpe->wavelength >= 0)
 	{
-		threads[ci]->getGlobalStats().aseNoiseTotal += ase;
-		threads[ci]->getGlobalStats().fwmNoiseTotal += fwm;
-		threads[ci]->getGlobalStats().xpmNoiseTotal += xpm;
+		ctx->getThread()->getGlobalStats().aseNoiseTotal += ase;
+		ctx->getThread()->getGlobalStats().fwmNoiseTotal += fwm;
+		ctx->getThread()->getGlobalStats().xpmNoiseTotal += xpm;
 
 		unsigned int spans = 0;
 
@@ -2654,7 +2979,7 @@ void ResourceManager::calc_min_spans()
 
 	span_distance = new unsigned short int[threadZero->getNumberOfRouters() * threadZero->getNumberOfRouters()];
 
-	unsigned int maxMinDistance = 0;
+	maxMinDistance = 0;
 
 	for(unsigned short int r1 = 0; r1 < threadZero->getNumberOfRouters(); ++r1)
 	{
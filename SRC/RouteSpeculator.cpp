@@ -0,0 +1,461 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      RouteSpeculator.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the RouteSpeculator
+//					class. Only the simulation thread changes the link state,
+//					and it cancels the running speculations before it does, so
+//					the helper threads never read an edge while it changes. A
+//					speculation that is finished keeps the edge versions it
+//					was started with and is checked against them once its
+//					request is handled.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, speculative route calculation.
+//
+// ____________________________________________________________________________
+
+#include "RouteSpeculator.h"
+#include "Thread.h"
+
+extern Thread* threadZero;
+extern Thread** threads;
+
+struct SpeculationWorker
+{
+	RouteSpeculator* speculator;
+	unsigned short int index;
+};
+
+void *runSpeculationWorker(void* n);
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	RouteSpeculator
+// Description:		Collects the edges of the thread and starts the
+//					helper threads, each with its own context.
+//
+///////////////////////////////////////////////////////////////////
+RouteSpeculator::RouteSpeculator(unsigned short int ci, unsigned short int threadCount)
+{
+	controllerIndex = ci;
+	probesToSend = 1;
+
+	numberOfEdges = 0;
+
+	for(unsigned short int r = 0; r < threadZero->getNumberOfRouters(); ++r)
+		numberOfEdges += threads[controllerIndex]->getRouterAt(r)->getNumberOfEdges();
+
+	edges = new Edge*[numberOfEdges];
+
+	unsigned int num = 0;
+
+	for(unsigned short int r = 0; r < threadZero->getNumberOfRouters(); ++r)
+	{
+		Router* router = threads[controllerIndex]->getRouterAt(r);
+
+		for(unsigned short int e = 0; e < router->getNumberOfEdges(); ++e)
+			edges[num++] = router->getEdgeByIndex(e);
+	}
+
+	workerCount = threadCount;
+
+	if(workerCount < 1)
+		workerCount = 1;
+
+	workersRunning = 0;
+	workerShutdown = false;
+
+	pthread_mutex_init(&workerMutex,NULL);
+	pthread_cond_init(&workerStart,NULL);
+	pthread_cond_init(&workerDone,NULL);
+
+	workers = new pthread_t[workerCount];
+	workerContext = new SimulationContext*[workerCount];
+	workerRoute = new SpeculatedRoute*[workerCount];
+
+	for(unsigned short int w = 0; w < workerCount; ++w)
+	{
+		workerContext[w] = new SimulationContext(threads[controllerIndex],controllerIndex,&threadZero->getQualityParams(),
+			threadZero->getResourceManager(),threadZero->getNumberOfRouters(),threadZero->getNumberOfWavelengths());
+		workerContext[w]->setSpeculation(this,w);
+
+		workerRoute[w] = 0;
+
+		SpeculationWorker* sw = new SpeculationWorker;
+		sw->speculator = this;
+		sw->index = w;
+
+		pthread_create(&workers[w],NULL,runSpeculationWorker,sw);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~RouteSpeculator
+// Description:		Stops the helper threads and frees the pending
+//					speculations.
+//
+///////////////////////////////////////////////////////////////////
+RouteSpeculator::~RouteSpeculator()
+{
+	cancel();
+
+	pthread_mutex_lock(&workerMutex);
+	workerShutdown = true;
+	pthread_cond_broadcast(&workerStart);
+	pthread_mutex_unlock(&workerMutex);
+
+	for(unsigned short int w = 0; w < workerCount; ++w)
+	{
+		pthread_join(workers[w],NULL);
+
+		delete workerContext[w];
+	}
+
+	reset(probesToSend);
+
+	delete[] workers;
+	delete[] workerContext;
+	delete[] workerRoute;
+
+	pthread_cond_destroy(&workerDone);
+	pthread_cond_destroy(&workerStart);
+	pthread_mutex_destroy(&workerMutex);
+
+	delete[] edges;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	reset
+// Description:		Drops every pending speculation before a new
+//					simulation and sets the number of paths that
+//					are calculated for each request.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::reset(unsigned short int probes)
+{
+	cancel();
+
+	for(map<RequestKey,SpeculatedRoute*>::iterator iter = pending.begin(); iter != pending.end(); ++iter)
+	{
+		freePaths(iter->second);
+
+		delete[] iter->second->versions;
+		delete iter->second;
+	}
+
+	pending.clear();
+
+	probesToSend = probes;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addRequest
+// Description:		Adds a connection request that was put in the
+//					event queue at the given time.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::addRequest(double time, ConnectionRequestEvent* cre)
+{
+	SpeculatedRoute* sr = new SpeculatedRoute;
+
+	sr->request = cre;
+	sr->state = SPECULATION_IDLE;
+	sr->cancelled = false;
+	sr->versions = new unsigned int[numberOfEdges];
+	sr->paths = 0;
+
+	pthread_mutex_lock(&workerMutex);
+	pending[RequestKey(time,cre->session)] = sr;
+	pthread_mutex_unlock(&workerMutex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	schedule
+// Description:		Hands the next requests in the event queue to
+//					the helper threads, one for each helper. Paths
+//					that are out of date are calculated again.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::schedule()
+{
+	pthread_mutex_lock(&workerMutex);
+
+	unsigned short int n = 0;
+
+	for(map<RequestKey,SpeculatedRoute*>::iterator iter = pending.begin(); iter != pending.end() && n < workerCount; ++iter, ++n)
+	{
+		SpeculatedRoute* sr = iter->second;
+
+		if(sr->state == SPECULATION_DONE && validate(sr) == false)
+		{
+			freePaths(sr);
+			sr->state = SPECULATION_IDLE;
+		}
+
+		if(sr->state == SPECULATION_IDLE)
+		{
+			for(unsigned int e = 0; e < numberOfEdges; ++e)
+				sr->versions[e] = edges[e]->getVersion();
+
+			sr->state = SPECULATION_QUEUED;
+			queued.push_back(sr);
+
+			pthread_cond_signal(&workerStart);
+		}
+	}
+
+	pthread_mutex_unlock(&workerMutex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	cancel
+// Description:		Called by the simulation thread before it
+//					changes the link state. Waiting speculations go
+//					back to idle, running ones are told to stop and
+//					the call returns once all helpers are idle.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::cancel()
+{
+	pthread_mutex_lock(&workerMutex);
+
+	while(queued.empty() == false)
+	{
+		queued.front()->state = SPECULATION_IDLE;
+		queued.pop_front();
+	}
+
+	for(unsigned short int w = 0; w < workerCount; ++w)
+	{
+		if(workerRoute[w] != 0)
+			workerRoute[w]->cancelled = true;
+	}
+
+	while(workersRunning > 0)
+		pthread_cond_wait(&workerDone,&workerMutex);
+
+	pthread_mutex_unlock(&workerMutex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	takeRoute
+// Description:		Removes the request from the pending requests
+//					and returns its speculated paths when no edge
+//					has changed since they were calculated. Returns
+//					zero otherwise, conflict is set when paths were
+//					found out of date.
+//
+///////////////////////////////////////////////////////////////////
+kShortestPathReturn* RouteSpeculator::takeRoute(double time, ConnectionRequestEvent* cre, bool &conflict)
+{
+	kShortestPathReturn* paths = 0;
+
+	conflict = false;
+
+	pthread_mutex_lock(&workerMutex);
+
+	map<RequestKey,SpeculatedRoute*>::iterator iter = pending.find(RequestKey(time,cre->session));
+
+	if(iter == pending.end() || iter->second->request != cre)
+	{
+		pthread_mutex_unlock(&workerMutex);
+		return 0;
+	}
+
+	SpeculatedRoute* sr = iter->second;
+
+	pending.erase(iter);
+
+	//The request is about to be handled, so a running speculation is worth waiting for
+	while(sr->state == SPECULATION_RUNNING)
+		pthread_cond_wait(&workerDone,&workerMutex);
+
+	if(sr->state == SPECULATION_QUEUED)
+		removeQueued(sr);
+
+	if(sr->state == SPECULATION_DONE)
+	{
+		if(validate(sr) == true)
+		{
+			paths = sr->paths;
+			sr->paths = 0;
+		}
+		else
+		{
+			conflict = true;
+		}
+	}
+
+	pthread_mutex_unlock(&workerMutex);
+
+	freePaths(sr);
+
+	delete[] sr->versions;
+	delete sr;
+
+	return paths;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	isCancelled
+// Description:		Returns true when the speculation running on
+//					helper w is no longer wanted.
+//
+///////////////////////////////////////////////////////////////////
+bool RouteSpeculator::isCancelled(unsigned short int w)
+{
+	pthread_mutex_lock(&workerMutex);
+
+	bool retVal = workerRoute[w] == 0 || workerRoute[w]->cancelled == true;
+
+	pthread_mutex_unlock(&workerMutex);
+
+	return retVal;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runWorker
+// Description:		Main loop of a helper thread, takes the next
+//					waiting speculation and calculates its paths
+//					with the routing algorithm of the thread.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::runWorker(unsigned short int w)
+{
+	pthread_mutex_lock(&workerMutex);
+
+	while(true)
+	{
+		while(workerShutdown == false && queued.empty() == true)
+			pthread_cond_wait(&workerStart,&workerMutex);
+
+		if(workerShutdown == true)
+			break;
+
+		SpeculatedRoute* sr = queued.front();
+		queued.pop_front();
+
+		sr->state = SPECULATION_RUNNING;
+		sr->cancelled = false;
+
+		workerRoute[w] = sr;
+		++workersRunning;
+
+		pthread_mutex_unlock(&workerMutex);
+
+		kShortestPathReturn* paths = threads[controllerIndex]->calculatePaths(sr->request->sourceRouterIndex,
+			sr->request->destinationRouterIndex,probesToSend,workerContext[w]);
+
+		pthread_mutex_lock(&workerMutex);
+
+		sr->paths = paths;
+
+		if(sr->cancelled == true)
+		{
+			freePaths(sr);
+			sr->state = SPECULATION_IDLE;
+		}
+		else
+		{
+			sr->state = SPECULATION_DONE;
+		}
+
+		workerRoute[w] = 0;
+		--workersRunning;
+
+		pthread_cond_broadcast(&workerDone);
+	}
+
+	pthread_mutex_unlock(&workerMutex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	validate
+// Description:		Returns true when no edge has changed since the
+//					paths of the speculation were calculated.
+//
+///////////////////////////////////////////////////////////////////
+bool RouteSpeculator::validate(SpeculatedRoute* sr)
+{
+	for(unsigned int e = 0; e < numberOfEdges; ++e)
+	{
+		if(sr->versions[e] != edges[e]->getVersion())
+			return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	freePaths
+// Description:		Deletes the speculated paths, if there are any.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::freePaths(SpeculatedRoute* sr)
+{
+	if(sr->paths == 0)
+		return;
+
+	delete[] sr->paths->pathcost;
+	delete[] sr->paths->pathinfo;
+	delete[] sr->paths->pathlen;
+
+	delete sr->paths;
+
+	sr->paths = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	removeQueued
+// Description:		Takes a waiting speculation out of the queue of
+//					the helper threads.
+//
+///////////////////////////////////////////////////////////////////
+void RouteSpeculator::removeQueued(SpeculatedRoute* sr)
+{
+	for(deque<SpeculatedRoute*>::iterator iter = queued.begin(); iter != queued.end(); ++iter)
+	{
+		if(*iter == sr)
+		{
+			queued.erase(iter);
+			break;
+		}
+	}
+
+	sr->state = SPECULATION_IDLE;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runSpeculationWorker
+// Description:		Entry point of a helper thread.
+//
+///////////////////////////////////////////////////////////////////
+void *runSpeculationWorker(void* n)
+{
+	SpeculationWorker* sw = static_cast<SpeculationWorker*>(n);
+
+	sw->speculator->runWorker(sw->index);
+
+	delete sw;
+
+	return 0;
+}
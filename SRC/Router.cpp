@@ -55,9 +55,6 @@ Router::Router()
 	avgQTo = 0.0;
 	avgQFrom = 0.0;
 #endif
-
-	destinationProbs = 0;
-	acoProbs = 0;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -73,9 +70,6 @@ Router::~Router()
 
 	edgeList.clear();
 
-	delete[] destinationProbs;
-	delete[] acoProbs;
-
 #ifdef RUN_GUI
 	destroy_bitmap(routerpic);
 #endif
@@ -137,92 +131,6 @@ void Router::updateUsage()
 	}
 }
 
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	generateACOProbabilities
-// Description:		Updates the ACO probabilities based upon the
-//					current pheremone levels.
-//
-///////////////////////////////////////////////////////////////////
-void Router::generateACOProbabilities(unsigned int dest)
-{
-	double *destinationTaus = new double[getNumberOfEdges()];
-	double *destinationEtas = new double[getNumberOfEdges()];
-
-	if(acoProbs == 0)
-	{
-		acoProbs = new double[getNumberOfEdges()];
-	}
-
-	for(unsigned int e = 0; e < getNumberOfEdges(); ++e)
-	{
-		if(getEdgeByIndex(e)->getSourceIndex() == getIndex())
-		{
-			destinationTaus[e] = getEdgeByIndex(e)->getPheremone();
-
-			if(getEdgeByIndex(e)->getDestinationIndex() != dest)
-			{
-				destinationEtas[e] = 1.0 / double(threadZero->getResourceManager()->span_distance[getEdgeByIndex(e)->getDestinationIndex() * threadZero->getNumberOfRouters() + dest]);
-			}
-			else
-			{
-				destinationEtas[e] = 1.0;
-			}
-		}
-		else
-		{
-			destinationTaus[e] = 0.0;
-			destinationEtas[e] = 0.0;
-		}
-	}
-
-	double cumulativeProduct = 0.0;
-
-	for(unsigned int e2 = 0; e2 < getNumberOfEdges(); ++e2)
-	{
-		destinationTaus[e2] = pow(destinationTaus[e2],double(threadZero->getQualityParams().ACO_alpha));
-		destinationEtas[e2] = pow(destinationEtas[e2],double(threadZero->getQualityParams().ACO_beta));
-
-		cumulativeProduct += destinationTaus[e2] * destinationEtas[e2];
-	}
-
-	for(unsigned int e3 = 0; e3 < getNumberOfEdges(); ++e3)
-	{
-		acoProbs[e3] = (destinationTaus[e3] * destinationEtas[e3]) / cumulativeProduct;
-
-		if(e3 > 0)
-			acoProbs[e3] += acoProbs[e3-1];
-	}
-
-	acoProbs[getNumberOfEdges() - 1] = 1.0;
-
-	delete[] destinationTaus;
-	delete[] destinationEtas;
-}
-
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	chooseEdge
-// Description:		Randomly chooses an edge based upon the 
-//					probabilities.
-//
-///////////////////////////////////////////////////////////////////
-Edge* Router::chooseEdge(float p)
-{
-	if(p <= acoProbs[0])
-		return getEdgeByIndex(0);
-
-	for(unsigned int r = 0; r < getNumberOfEdges(); ++r)
-	{
-		if(p > acoProbs[r] && p <= acoProbs[r+1])
-		{
-			return getEdgeByIndex(r+1);
-		}
-	}
-
-	return 0;
-}
-
 #ifdef RUN_GUI
 
 ///////////////////////////////////////////////////////////////////
@@ -263,86 +171,6 @@ void Router::updateGUI()
 }
 #endif
 
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	generateProbabilities
-// Description:		Generates the probabilites as destionations.
-//
-///////////////////////////////////////////////////////////////////
-void Router::generateProbabilities()
-{
-	double totalProbs = 0.0;
-	double cumulativeProbs = 0.0;
-
-	unsigned int pathSpans = 0;
-
-	destinationProbs = new double[threadZero->getNumberOfRouters()];
-
-	for(unsigned int r1 = 0; r1 < threadZero->getNumberOfRouters(); ++r1)
-	{
-		if(r1 != getIndex())
-		{
-			pathSpans = 0;
-
-			kShortestPathReturn *kPath = threadZero->getResourceManager()->calculate_SP_path(r1,getIndex(),1,0);
-
-			for(unsigned int r2 = 0; r2 < kPath->pathlen[0] - 1; ++r2)
-				pathSpans += threadZero->getRouterAt(kPath->pathinfo[r2])->
-					getEdgeByDestination(kPath->pathinfo[r2+1])->getNumberOfSpans();
-
-			if(threadZero->getQualityParams().dest_dist == DISTANCE)
-				destinationProbs[r1] = pathSpans;
-			else if(threadZero->getQualityParams().dest_dist == INVERSE_DISTANCE)
-				destinationProbs[r1] = 1.0 / pathSpans;
-			else
-				destinationProbs[r1] = 1.0;
-
-			totalProbs += destinationProbs[r1];
-
-			delete[] kPath->pathcost;
-			delete[] kPath->pathinfo;
-			delete[] kPath->pathlen;
-
-			delete kPath;
-		}
-		else
-		{
-			destinationProbs[r1] = 0.0;
-		}
-	}
-
-	for(unsigned int r2 = 0; r2 < threadZero->getNumberOfRouters(); ++r2)
-	{
-		destinationProbs[r2] = destinationProbs[r2] / totalProbs;
-
-		cumulativeProbs += destinationProbs[r2];
-		destinationProbs[r2] = cumulativeProbs;
-	}
-}
-
-///////////////////////////////////////////////////////////////////
-//
-// Function Name:	generateDestination
-// Description:		Generates a destination based upon the
-//					probability distribution.
-//
-///////////////////////////////////////////////////////////////////
-unsigned int Router::generateDestination(double p)
-{
-	if(p < destinationProbs[0])
-		return 0;
-
-	for(unsigned int r = 0; r < threadZero->getNumberOfRouters() - 1; ++r)
-	{
-		if(p > destinationProbs[r] && p < destinationProbs[r+1])
-		{
-			return r + 1;
-		}
-	}
-
-	return -1;
-}
-
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	resetUsage
@@ -0,0 +1,164 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      SimulationContext.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the SimulationContext
+//					class. The SimulationContext is handed to the routing and
+//					Q-factor code in place of a controller index. It splits the
+//					data that every simulation shares and only reads (quality
+//					parameters, nonlinear tables) from the state that belongs
+//					to the simulation running on one thread.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, per thread simulation context.
+//
+// ____________________________________________________________________________
+
+#include "ResourceManager.h"
+#include "RouteSpeculator.h"
+#include "SimulationContext.h"
+#include "Thread.h"
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	SimulationContext
+// Description:		Constructor that takes the thread running the
+//					simulation and the data shared by all threads.
+//
+///////////////////////////////////////////////////////////////////
+SimulationContext::SimulationContext(Thread* t, unsigned short int ci, const QualityParameters* qp, ResourceManager* r,
+	unsigned short int routers, unsigned short int wavelengths)
+{
+	thread = t;
+	controllerIndex = ci;
+
+	quality = qp;
+	physical = &r->getPhysicalParams();
+	rm = r;
+
+	numberOfRouters = routers;
+	numberOfWavelengths = wavelengths;
+
+	SP_paths = 0;
+
+	//A path never has more edges than there are routers
+	linkStateRows = new const int*[numberOfRouters];
+
+	speculator = 0;
+	speculationWorker = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~SimulationContext
+// Description:		Default destructor with no arguements.
+//
+///////////////////////////////////////////////////////////////////
+SimulationContext::~SimulationContext()
+{
+	freeSPMatrix();
+
+	delete[] linkStateRows;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	initSPMatrix
+// Description:		Initializes the SP matrix so that the paths
+//					can be stored.
+//
+///////////////////////////////////////////////////////////////////
+void SimulationContext::initSPMatrix()
+{
+	if(SP_paths != 0)
+		return;
+
+	SP_paths = new kShortestPathReturn*[numberOfRouters * numberOfRouters];
+
+	for(unsigned int p = 0; p < static_cast<unsigned int>(numberOfRouters * numberOfRouters); ++p)
+	{
+		SP_paths[p] = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	freeSPMatrix
+// Description:		Free the SP matrix so that the memory can be
+//					reused.
+//
+///////////////////////////////////////////////////////////////////
+void SimulationContext::freeSPMatrix()
+{
+	if(SP_paths == 0)
+		return;
+
+	for(unsigned int p = 0; p < static_cast<unsigned int>(numberOfRouters * numberOfRouters); ++p)
+	{
+		if(SP_paths[p] != 0)
+		{
+			delete[] SP_paths[p]->pathcost;
+			delete[] SP_paths[p]->pathinfo;
+			delete[] SP_paths[p]->pathlen;
+
+			delete SP_paths[p];
+		}
+	}
+
+	delete[] SP_paths;
+
+	SP_paths = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	isSpeculationCancelled
+// Description:		Returns true when the route being calculated on
+//					a speculation helper thread is no longer wanted.
+//					Always false on the simulation thread.
+//
+///////////////////////////////////////////////////////////////////
+bool SimulationContext::isSpeculationCancelled()
+{
+	if(speculator == 0)
+		return false;
+
+	return speculator->isCancelled(speculationWorker);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	chargeRouteBudget
+// Description:		Charges the compute budget of the routing request
+//					on the simulation thread. A speculation helper
+//					has no budget, it only stops once cancelled.
+//
+///////////////////////////////////////////////////////////////////
+bool SimulationContext::chargeRouteBudget(unsigned int ops)
+{
+	if(speculator != 0)
+		return speculator->isCancelled(speculationWorker);
+
+	return thread->chargeRouteBudget(ops);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getRouteBudgetCut
+// Description:		Returns true once the routing request has to
+//					return the best paths found so far.
+//
+///////////////////////////////////////////////////////////////////
+bool SimulationContext::getRouteBudgetCut()
+{
+	if(speculator != 0)
+		return speculator->isCancelled(speculationWorker);
+
+	return thread->getRouteBudgetCut();
+}
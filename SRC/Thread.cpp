@@ -23,6 +23,9 @@
 
 #include "Thread.h"
 
+#include <limits>
+#include <string.h>
+
 #ifdef RUN_GUI
 
 #include "AllegroWrapper.h"
@@ -36,11 +39,16 @@ extern BITMAP *popup;
 extern Thread* threadZero;
 extern Thread** threads;
 extern unsigned short int threadCount;
+extern NetworkTopology* network;
 
 extern vector<AlgorithmToRun*> algParams;
 
 extern char* itoa( int value, char* result, int base );
 
+static void addResult(vector<string> &names, vector<double> &values, const char* name, double value);
+static unsigned int mixSeed(boost::uint64_t x);
+static void fillVariants(float* list, unsigned short int count, unsigned short int variants, float base);
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	Thread
@@ -93,6 +101,40 @@ Thread::Thread(int ci, int argc, const char* argv[], bool isLPS, int rc)
 	controllerIndex = ci;
 	setGlobalTime(0.0);
 
+	colony = 0;
+	qualityPool = 0;
+	speculator = 0;
+
+	handlers = 0;
+	wavelengthHandler = 0;
+
+	context = 0;
+	replicationStats = 0;
+
+	batchMeans = 0;
+	trafficStopped = false;
+	trafficStopTime = 0.0;
+
+	warmup = 0;
+
+	CurrentStages = 1;
+	currentStage = 0;
+	stageWorkstations = 0;
+	stageSettled = false;
+
+	CurrentWarmFork = false;
+	warmSnapshot = 0;
+
+	traceReader = 0;
+	traceRecorder = 0;
+	traceSession = 0;
+
+	routeBudgetOps = 0;
+	routeBudgetLimit = 0;
+	routeBudgetStart = 0.0;
+	routeBudgetTime = 0.0;
+	routeBudgetCut = false;
+
 	char fileName[200];
 
 	if(controllerIndex == 0 && isLoadPrevious == false)
@@ -100,16 +142,30 @@ Thread::Thread(int ci, int argc, const char* argv[], bool isLPS, int rc)
 		logger = new MessageLogger(argv[1],argv[2],argv[3],argv[6],rc);
 
 		sprintf(fileName,"INPUT/Quality-%s-%s.txt",argv[1],argv[2]);
+		maxRunCount = countParameterSets(fileName) - 1;
 		setQualityParameters(fileName);
+
+		if(maxRunCount > 0)
+		{
+			sprintf(fileName,"PARAMETER SET %d OF %d",runCount + 1,maxRunCount + 1);
+			recordEvent(fileName,true,0);
+		}
 	}
 
 	topology = argv[1];
 
-	sprintf(fileName,"INPUT/Topology-%s.txt",argv[1]);
-	setTopologyParameters(fileName);
+	//The input files of the topology are only read by the first thread of the first run
+	if(network == 0)
+		network = new NetworkTopology(argv[1],argv[2]);
+
+#ifdef RUN_GUI
+	sprintf(topoFile,"INPUT/Topology-%s.txt",argv[1]);
+	sprintf(wkstFile,"INPUT/Workstation-%s-%s.txt",argv[1],argv[2]);
+#endif
+
+	buildNetwork();
 
-	sprintf(fileName,"INPUT/Workstation-%s-%s.txt",argv[1],argv[2]);
-	setWorkstationParameters(fileName);
+	sprintf(traceName,"%s-%s",argv[1],argv[2]);
 
 	if(controllerIndex == 0 && isLoadPrevious == false)
 	{
@@ -118,6 +174,9 @@ Thread::Thread(int ci, int argc, const char* argv[], bool isLPS, int rc)
 		sprintf(fileName,"INPUT/Algorithm.txt");
 		setAlgorithmParameters(fileName,atoi(argv[5]));
 
+		if(qualityParams.replications > 1)
+			replicationStats = new ReplicationStats(static_cast<unsigned short int>(qualityParams.replications));
+
 		numberOfConnections = static_cast<unsigned int>(TEN_HOURS) / 
 			static_cast<unsigned int>(threadZero->getQualityParams().arrival_interval);
 	}
@@ -131,8 +190,12 @@ Thread::Thread(int ci, int argc, const char* argv[], bool isLPS, int rc)
 		queue = new EventQueue();
 
 		randomSeed = atoi(argv[3]);
+		currentSeed = randomSeed;
+
+		CurrentReplication = 0;
 
 		order_init = false;
+		orderSeed = 0;
 		workstationOrder = new unsigned short int[getNumberOfWorkstations()];
 	}
 
@@ -158,14 +221,9 @@ Thread::~Thread()
 		delete logger;
 		delete rm;
 
-		for(unsigned short int a = 0; a < NUMBER_OF_ROUTING_ALGORITHMS; ++a)
-			delete RoutingAlgorithmNames[a];
+		delete replicationStats;
 
-		for(unsigned short int w = 0; w < NUMBER_OF_WAVELENGTH_ALGORITHMS; ++w)
-			delete WavelengthAlgorithmNames[w];
-
-		for(unsigned short int p = 0; p < NUMBER_OF_PROBE_STYLES; ++p)
-			delete ProbeStyleNames[p];
+		deleteAlgorithmNames();
 	}
 
 	for(unsigned short int r = 0; r < routers.size(); ++r)
@@ -176,11 +234,31 @@ Thread::~Thread()
 
 	routers.clear();
 	workstations.clear();
+
+	delete[] linkState;
 	
 	if(isLoadPrevious == false)
 	{
 		delete[] workstationOrder;
 	}
+
+	delete speculator;
+	delete colony;
+	delete qualityPool;
+
+	delete context;
+
+	delete batchMeans;
+
+	delete warmup;
+
+	delete traceReader;
+	delete traceRecorder;
+
+	delete warmSnapshot;
+
+	for(unsigned short int a = 0; a < forkAlgorithms.size(); ++a)
+		delete forkAlgorithms[a];
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -192,9 +270,15 @@ Thread::~Thread()
 ///////////////////////////////////////////////////////////////////
 void Thread::initPriorityQueue(unsigned short int w)
 {
+	//The algorithms forked from a warm state start at the time of the snapshot
+	double start = 0.0;
+
+	if(warmSnapshot != 0)
+		start = warmSnapshot->time;
+
 	Event* activate = new Event;
 	activate->e_type = ACTIVATE_WORKSTATIONS;
-	activate->e_time = 0.0;
+	activate->e_time = start;
 	activate->e_data = 0;
 
 	Event* deactivate = new Event;
@@ -208,12 +292,38 @@ void Thread::initPriorityQueue(unsigned short int w)
 	delete deactivate;
 	delete activate;
 
+	if(CurrentStages > 1)
+	{
+		Event* event = new Event();
+
+		event->e_type = NEXT_LOAD_STAGE;
+		event->e_time = TEN_HOURS / double(CurrentStages) * threadZero->getQualityParams().load_ramp_settle;
+		event->e_data = 0;
+
+		queue->addEvent(*event);
+
+		delete event;
+	}
+
+	if(CurrentWarmFork == true)
+	{
+		Event* event = new Event();
+
+		event->e_type = TAKE_SNAPSHOT;
+		event->e_time = TEN_HOURS * threadZero->getQualityParams().warm_fork_settle;
+		event->e_data = 0;
+
+		queue->addEvent(*event);
+
+		delete event;
+	}
+
 	if(CurrentRoutingAlgorithm == PABR || CurrentRoutingAlgorithm == LORA)
 	{
 		Event* event = new Event();
 
 		event->e_type = UPDATE_USAGE;
-		event->e_time = 0.0;
+		event->e_time = start;
 		event->e_data = 0;
 
 		queue->addEvent(*event);
@@ -249,13 +359,92 @@ void Thread::initResourceManager()
 	else
 		rm = 0;
 
-	for(unsigned int r = 0; r < getNumberOfRouters(); ++r)
-	{
-		if(threadZero->getQualityParams().dest_dist != UNIFORM)
-		{
-			getRouterAt(r)->generateProbabilities();
-		}
-	}
+	context = new SimulationContext(this,controllerIndex,&threadZero->getQualityParams(),
+		threadZero->getResourceManager(),threadZero->getNumberOfRouters(),threadZero->getNumberOfWavelengths());
+
+	if(controllerIndex == 0 && threadZero->getQualityParams().dest_dist != UNIFORM)
+		network->buildDestinationTables(context);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	loadParameterSet
+// Description:		Reads the next set of quality parameters and
+//					the algorithms to run with them. The threads,
+//					the network and the tables of the Resource
+//					Manager that do not depend on the changed
+//					parameters are kept from the previous set.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::loadParameterSet(int argc, const char* argv[], int rc)
+{
+	//Only the scalar parameters of the previous set are compared
+	QualityParameters previous = qualityParams;
+
+	runCount = rc;
+
+	delete logger;
+	logger = new MessageLogger(argv[1],argv[2],argv[3],argv[6],rc);
+
+	char fileName[200];
+
+	sprintf(fileName,"INPUT/Quality-%s-%s.txt",argv[1],argv[2]);
+	setQualityParameters(fileName);
+
+	qualityParams.max_probes = atoi(argv[6]);
+
+	char buffer[100];
+	sprintf(buffer,"PARAMETER SET %d OF %d",runCount + 1,maxRunCount + 1);
+	recordEvent(buffer,true,0);
+
+	deleteAlgorithmNames();
+
+	sprintf(fileName,"INPUT/Algorithm.txt");
+	setAlgorithmParameters(fileName,atoi(argv[5]));
+
+	delete replicationStats;
+	replicationStats = 0;
+
+	if(qualityParams.replications > 1)
+		replicationStats = new ReplicationStats(static_cast<unsigned short int>(qualityParams.replications));
+
+	numberOfConnections = static_cast<unsigned int>(TEN_HOURS) / 
+		static_cast<unsigned int>(qualityParams.arrival_interval);
+
+	rm->updateParameters(previous);
+
+	delete[] previous.ASE_perEDFA;
+
+	resetParameterSet();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	resetParameterSet
+// Description:		Drops the helpers sized from the quality
+//					parameters of the previous set, they are built
+//					again by the first simulation of the next set.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::resetParameterSet()
+{
+	if(controllerIndex != 0)
+		setMinDuration(static_cast<unsigned short>(ceil(threadZero->maxSpans * threadZero->getQualityParams().QFactor_factor)));
+
+	delete colony;
+	colony = 0;
+
+	delete qualityPool;
+	qualityPool = 0;
+
+	delete speculator;
+	speculator = 0;
+
+	delete batchMeans;
+	batchMeans = 0;
+
+	delete warmup;
+	warmup = 0;
 }
 ///////////////////////////////////////////////////////////////////
 //
@@ -271,6 +460,21 @@ void Thread::initThread(AlgorithmToRun* alg)
 	CurrentProbeStyle = alg->ps;
 	CurrentQualityAware = alg->qa;
 	CurrentActiveWorkstations = alg->workstations;
+	CurrentReplication = alg->replication;
+
+	CurrentStages = alg->stages;
+	currentStage = 0;
+	stageWorkstations = alg->workstations;
+	stageSettled = false;
+	stageBlocking.clear();
+
+	CurrentWarmFork = alg->warmFork;
+
+	handlers = &eventHandlers[CurrentRoutingAlgorithm][CurrentProbeStyle];
+	wavelengthHandler = ResourceManager::wavelengthHandlers[CurrentWavelengthAlgorithm][CurrentQualityAware == true ? 1 : 0];
+
+	//Every replication draws from its own random streams
+	currentSeed = getReplicationSeed(CurrentReplication);
 
 #ifdef RUN_GUI
 	rectfill(mainbuf, 0, 50*controllerIndex+85-1, SCREEN_W, 50*(controllerIndex+1)+85-1, makecol(0,0,0));
@@ -288,17 +492,74 @@ void Thread::initThread(AlgorithmToRun* alg)
 	delete alg;
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getReplicationSeed
+// Description:		Returns the random seed of a replication. The
+//					first replication uses the seed from the command
+//					line, the others are spread out from it so their
+//					random streams do not overlap.
+//
+///////////////////////////////////////////////////////////////////
+unsigned int Thread::getReplicationSeed(unsigned short int r)
+{
+	if(r == 0)
+		return randomSeed;
+
+	return mixSeed((boost::uint64_t(randomSeed) << 16) | r);
+}
+
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	runThread
 // Description:		Runs the simulation for the program until there
-//					are no more events to run.
+//					are no more events to run. With warm_fork the
+//					other algorithms are run afterwards, each one
+//					continuing from the snapshot of the first.
 //
 ///////////////////////////////////////////////////////////////////
 int Thread::runThread(AlgorithmToRun* alg)
 {
+	vector<AlgorithmToRun*> forks;
+
+	if(alg->warmFork == true)
+	{
+		for(unsigned short int a = 0; a < threadZero->getForkAlgorithms().size(); ++a)
+		{
+			AlgorithmToRun* f = new AlgorithmToRun(*threadZero->getForkAlgorithms()[a]);
+
+			f->workstations = alg->workstations;
+			f->replication = alg->replication;
+
+			forks.push_back(f);
+		}
+	}
+
 	initThread(alg);
+	runEvents();
+
+	for(unsigned short int a = 0; a < forks.size(); ++a)
+	{
+		initThread(forks[a]);
+		runEvents();
+	}
+
+	delete warmSnapshot;
+	warmSnapshot = 0;
+
+	return getRunStatus();
+}
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	runEvents
+// Description:		Runs the events of the current simulation until
+//					there are no more events to run.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::runEvents()
+{
 #ifdef RUN_GUI
 	rectfill(mainbuf, 49, controllerIndex * 50 + 99, 651, controllerIndex * 50 + 99 + 26, makecol(0,0,255));
 #endif
@@ -339,6 +600,12 @@ int Thread::runThread(AlgorithmToRun* alg)
 			case DEACTIVATE_WORKSTATIONS:
 				deactivate_workstations();
 				break;
+			case NEXT_LOAD_STAGE:
+				next_load_stage();
+				break;
+			case TAKE_SNAPSHOT:
+				take_snapshot();
+				break;
 			case UPDATE_USAGE:
 				update_link_usage();
 				break;
@@ -348,20 +615,20 @@ int Thread::runThread(AlgorithmToRun* alg)
 				break;
 #endif
 			case CONNECTION_REQUEST:
-				connection_request(static_cast<ConnectionRequestEvent*>(event.e_data));
+				(this->*handlers->connectionRequest)(static_cast<ConnectionRequestEvent*>(event.e_data));
 				delete static_cast<ConnectionRequestEvent*>(event.e_data);
 				break;
 			case COLLISION_NOTIFICATION:
-				collision_notification(static_cast<CollisionNotificationEvent*>(event.e_data));
+				(this->*handlers->collisionNotification)(static_cast<CollisionNotificationEvent*>(event.e_data));
 				break;
 			case CREATE_CONNECTION_PROBE:
-				create_connection_probe(static_cast<CreateConnectionProbeEvent*>(event.e_data));
+				(this->*handlers->createConnectionProbe)(static_cast<CreateConnectionProbeEvent*>(event.e_data));
 				break;
 			case CREATE_CONNECTION_CONFIRMATION:
-				create_connection_confirmation(static_cast<CreateConnectionConfirmationEvent*>(event.e_data));
+				(this->*handlers->createConnectionConfirmation)(static_cast<CreateConnectionConfirmationEvent*>(event.e_data));
 				break;
 			case DESTROY_CONNECTION_PROBE:
-				destroy_connection_probe(static_cast<DestroyConnectionProbeEvent*>(event.e_data));
+				(this->*handlers->destroyConnectionProbe)(static_cast<DestroyConnectionProbeEvent*>(event.e_data));
 				break;
 			default:
 				threadZero->recordEvent("ERROR: Unknown event type, exiting simulation.",true,controllerIndex);
@@ -369,15 +636,6 @@ int Thread::runThread(AlgorithmToRun* alg)
 				break;
 		}
 	}
-	
-	if(runCount != maxRunCount)
-	{
-		return MORE_SIMULATIONS;
-	}
-	else
-	{
-		return COMPLETED_ALL_SIMULATIONS;
-	}
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -394,64 +652,70 @@ void Thread::activate_workstations()
 	multFactor = 600.0 / float(getCurrentActiveWorkstations() * threadZero->getNumberOfConnections());
 #endif
 
-	stats.ConnectionRequests = 0;
-	stats.ConnectionSuccesses = 0;
-	stats.CollisionFailures = 0;
-	stats.NoPathFailures = 0;
-	stats.QualityFailures = 0;
-	stats.DroppedFailures = 0;
-	stats.ProbeSentCount = 0;
+	resetStats();
 
-	stats.totalSetupDelay = 0.0;
-	stats.totalHopCount = 0;
-	stats.totalSpanCount = 0;
+	trafficStopped = false;
+	trafficStopTime = TEN_HOURS;
 
-	stats.aseNoiseTotal = 0.0;
-	stats.fwmNoiseTotal = 0.0;
-	stats.xpmNoiseTotal = 0.0;
-	stats.raRunTime = 0.0;
+	if(threadZero->getQualityParams().stop_precision > 0.0)
+	{
+		if(batchMeans == 0)
+			batchMeans = new BatchMeans(threadZero->getQualityParams().stop_batch_size,
+				threadZero->getQualityParams().stop_min_batches,threadZero->getQualityParams().stop_precision);
+		else
+			batchMeans->reset(0,0);
+	}
 
-	//Random generator for destination router
-	rng.seed(boost::uint32_t(getRandomSeed()));
-	rt = new boost::uniform_int<>(0,getNumberOfRouters() - 1);
-	generateRandomRouter = new boost::variate_generator<boost::mt19937&, boost::uniform_int<> >(rng, *rt);
+	if(threadZero->getQualityParams().warmup_detect == true)
+	{
+		if(warmup == 0)
+			warmup = new WarmupDetector(threadZero->getQualityParams().warmup_check);
+		else
+			warmup->reset();
+	}
 
-	//Random generator for duration time
-	rng2.seed(boost::uint32_t(getRandomSeed()));
-	dt = new boost::exponential_distribution<>(1.0 / float(threadZero->getQualityParams().duration));
-	generateRandomDuration = new boost::variate_generator<boost::mt19937&, boost::exponential_distribution<> >(rng2, *dt);
+	//Every workstation draws its traffic from its own stream
+	trafficCount.assign(getNumberOfWorkstations(),0);
 
-	//Random generator for arrival interval
-	rng3.seed(boost::uint32_t(getRandomSeed() * getRandomSeed()));
-	ai = new boost::exponential_distribution<>(1.0 / float(threadZero->getQualityParams().arrival_interval));
-	generateArrivalInterval = new boost::variate_generator<boost::mt19937&, boost::exponential_distribution<> >(rng3, *ai);
+	if(CurrentRoutingAlgorithm == ACO || CurrentRoutingAlgorithm == MAX_MIN_ACO)
+	{
+		if(colony == 0)
+			colony = new AntColony(controllerIndex);
+		else
+			colony->resetColony();
+	}
 
-	//Random generator for zero to one
-	rng4.seed(boost::uint32_t(getRandomSeed()));
-	zo = new boost::uniform_real<>(0,1);
-	generateZeroToOne = new boost::variate_generator<boost::mt19937&, boost::uniform_real<> >(rng4, *zo);
+	//The pool is only needed by the algorithms that estimate the Q-factor of many wavelengths
+	if(threadZero->getQualityParams().Q_threads > 1 && qualityPool == 0 &&
+	   ((CurrentRoutingAlgorithm == DYNAMIC_PROGRAMMING && threadZero->getQualityParams().DP_alpha < 1.0) ||
+	    CurrentWavelengthAlgorithm == LEAST_QUALITY || CurrentWavelengthAlgorithm == MOST_QUALITY))
+	{
+		qualityPool = new QualityPool(controllerIndex,threadZero->getQualityParams().Q_threads,threadZero->getNumberOfWavelengths());
+	}
 
-	if(CurrentRoutingAlgorithm == SHORTEST_PATH)
+	//Only the routing algorithms whose paths depend on nothing but the link state are speculated
+	if(threadZero->getQualityParams().RA_speculate > 0 &&
+	   threadZero->getQualityParams().RA_budget_ops == 0 && threadZero->getQualityParams().RA_budget_time == 0.0 &&
+	   (CurrentRoutingAlgorithm == IMPAIRMENT_AWARE || CurrentRoutingAlgorithm == DYNAMIC_PROGRAMMING ||
+	    CurrentRoutingAlgorithm == LORA || CurrentRoutingAlgorithm == PABR))
 	{
-		threadZero->getResourceManager()->initSPMatrix();
+		if(speculator == 0)
+			speculator = new RouteSpeculator(controllerIndex,threadZero->getQualityParams().RA_speculate);
+
+		speculator->reset(CurrentProbeStyle == SINGLE ? 1 : threadZero->getQualityParams().max_probes);
 	}
 	else
 	{
-		bool SP_active = false;
-
-		for(unsigned int t = 0; t < threadCount; ++t)
-		{
-			if(threads[t]->getCurrentRoutingAlgorithm() == SHORTEST_PATH)
-			{
-				SP_active = true;
-				break;
-			}
-		}
-
-		if(SP_active == false)
-			threadZero->getResourceManager()->freeSPMatrix();
+		delete speculator;
+		speculator = 0;
 	}
 
+	//The shortest paths are kept by the context, so no other thread is involved
+	if(CurrentRoutingAlgorithm == SHORTEST_PATH)
+		context->initSPMatrix();
+	else
+		context->freeSPMatrix();
+
 	if(CurrentRoutingAlgorithm == ADAPTIVE_QoS)
 	{
 		for(unsigned int r = 0; r < getNumberOfRouters(); ++r)
@@ -460,13 +724,11 @@ void Thread::activate_workstations()
 		}
 	}
 
-	if(order_init == false)
+	if(order_init == false || orderSeed != getRandomSeed())
 	{
-		boost::mt19937 rng;
-		rng.seed(boost::uint32_t(getRandomSeed()));
-		boost::uniform_int<> wk(0,getNumberOfWorkstations() - 1);
-		boost::variate_generator<boost::mt19937&, boost::uniform_int<> > generateRandomWorkstation(rng, wk);
-		
+		boost::uint64_t key = CounterRandom::makeKey(getRandomSeed(),0);
+		unsigned int draw = 0;
+
 		bool* init = new bool[getNumberOfWorkstations()];
 
 		for(unsigned short int w = 0; w <getNumberOfWorkstations(); ++w)
@@ -479,7 +741,10 @@ void Thread::activate_workstations()
 
 		while(numberFound < getNumberOfWorkstations())
 		{
-			int wkstn = generateRandomWorkstation();
+			double p;
+			CounterRandom::generateZeroToOne(key,0,RANDOM_WORKSTATION_ORDER,draw++,1,&p);
+
+			int wkstn = static_cast<int>(p * getNumberOfWorkstations());
 
 			if(init[wkstn] == false)
 			{
@@ -493,6 +758,7 @@ void Thread::activate_workstations()
 		delete[] init;
 
 		order_init = true;
+		orderSeed = getRandomSeed();
 	}
 
 	char buffer[50];
@@ -525,9 +791,307 @@ void Thread::activate_workstations()
 		}
 	}
 
-	for(unsigned int w = 0; w < getNumberOfWorkstations(); ++w)
-		if(getWorkstationAt(w)->getActive() == true)
-			generateTrafficEvent(w * threadZero->getNumberOfConnections());
+	char fileName[250];
+
+	if(warmSnapshot != 0 && CurrentWarmFork == false)
+	{
+		restoreSnapshot();
+	}
+	else if(threadZero->getQualityParams().trace_mode == TRACE_REPLAY)
+	{
+		if(traceReader == 0)
+		{
+			sprintf(fileName,"INPUT/Trace-%s.bin",traceName);
+			traceReader = new TraceReader(fileName);
+		}
+		else
+		{
+			traceReader->rewind();
+		}
+
+		traceSession = 0;
+
+		replayTrafficEvent();
+	}
+	else
+	{
+		if(threadZero->getQualityParams().trace_mode == TRACE_RECORD)
+		{
+			sprintf(fileName,"OUTPUT/Trace-%s-%u-W%d-%s-%s-%s-Q%d.bin",traceName,currentSeed,getCurrentActiveWorkstations(),
+				threadZero->getRoutingAlgorithmName(CurrentRoutingAlgorithm)->c_str(),threadZero->getWavelengthAlgorithmName(CurrentWavelengthAlgorithm)->c_str(),
+				threadZero->getProbeStyleName(CurrentProbeStyle)->c_str(),getCurrentQualityAware());
+			traceRecorder = new TraceRecorder(fileName);
+		}
+
+		for(unsigned int w = 0; w < getNumberOfWorkstations(); ++w)
+			if(getWorkstationAt(w)->getActive() == true)
+				generateTrafficEvent(w * threadZero->getNumberOfConnections());
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	resetStats
+// Description:		Clears the statistics of the current simulation.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::resetStats()
+{
+	stats.ConnectionRequests = 0;
+	stats.ConnectionSuccesses = 0;
+	stats.CollisionFailures = 0;
+	stats.NoPathFailures = 0;
+	stats.QualityFailures = 0;
+	stats.DroppedFailures = 0;
+	stats.ProbeSentCount = 0;
+
+	stats.totalSetupDelay = 0.0;
+	stats.totalHopCount = 0;
+	stats.totalSpanCount = 0;
+
+	stats.aseNoiseTotal = 0.0;
+	stats.fwmNoiseTotal = 0.0;
+	stats.xpmNoiseTotal = 0.0;
+	stats.raRunTime = 0.0;
+
+	stats.acoColonies = 0;
+	stats.acoIterations = 0;
+	stats.acoWarmStarts = 0;
+
+	stats.raBudgetCuts = 0;
+
+	stats.raSpeculated = 0;
+	stats.raSpeculationConflicts = 0;
+
+	stats.fusedHops = 0;
+
+	stats.qmRequested = 0;
+	stats.qmRecalculated = 0;
+
+	for(unsigned short int v = 0; v < MAX_Q_VARIANTS; ++v)
+		stats.variantDroppedFailures[v] = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	next_load_stage
+// Description:		Moves the load ramp along. At the end of the
+//					settling window of a stage its statistics are
+//					cleared, at the end of the stage they are
+//					reported and the workstations of the next stage
+//					are activated. The last stage is reported when
+//					the workstations are deactivated.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::next_load_stage()
+{
+	double stageLength = TEN_HOURS / double(CurrentStages);
+
+	Event* event = new Event();
+
+	event->e_type = NEXT_LOAD_STAGE;
+	event->e_data = 0;
+
+	if(stageSettled == false)
+	{
+		resetStats();
+		clearEdgeStats();
+
+		stageSettled = true;
+
+		if(currentStage + 1 < CurrentStages)
+		{
+			event->e_time = double(currentStage + 1) * stageLength;
+			queue->addEvent(*event);
+		}
+	}
+	else
+	{
+		reportStats();
+
+		++currentStage;
+		stageSettled = false;
+
+		unsigned int previous = getCurrentActiveWorkstations();
+		setCurrentActiveWorkstations((currentStage + 1) * stageWorkstations);
+
+		char buffer[50];
+		sprintf(buffer,"Activate %d workstations.",getCurrentActiveWorkstations() - previous);
+		threadZero->recordEvent(buffer,false,controllerIndex);
+
+		for(unsigned int w = previous; w < getCurrentActiveWorkstations(); ++w)
+		{
+			getWorkstationAt(workstationOrder[w])->setActive(true);
+#ifdef RUN_GUI
+			getRouterAt(getWorkstationAt(workstationOrder[w])->getParentRouterIndex())->incNumWorkstations();
+#endif
+			sprintf(buffer,"\tActivate workstation %d",workstationOrder[w]);
+			threadZero->recordEvent(buffer,false,controllerIndex);
+
+			generateTrafficEvent(workstationOrder[w] * threadZero->getNumberOfConnections());
+		}
+
+		event->e_time = (double(currentStage) + threadZero->getQualityParams().load_ramp_settle) * stageLength;
+		queue->addEvent(*event);
+	}
+
+	delete event;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	take_snapshot
+// Description:		Keeps the warm state of the first algorithm for
+//					the other algorithms of the simulation, and
+//					clears the statistics so all of them are measured
+//					from the time of the snapshot on. Setups still on
+//					their way and connections already tearing down
+//					are not part of the snapshot.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::take_snapshot()
+{
+	delete warmSnapshot;
+	warmSnapshot = new NetworkSnapshot;
+
+	warmSnapshot->reference.ra = CurrentRoutingAlgorithm;
+	warmSnapshot->reference.wa = CurrentWavelengthAlgorithm;
+	warmSnapshot->reference.ps = CurrentProbeStyle;
+	warmSnapshot->reference.qa = CurrentQualityAware;
+	warmSnapshot->reference.workstations = getCurrentActiveWorkstations();
+	warmSnapshot->reference.replication = CurrentReplication;
+	warmSnapshot->reference.stages = 1;
+	warmSnapshot->reference.warmFork = true;
+
+	warmSnapshot->time = getGlobalTime();
+	warmSnapshot->trafficCount = trafficCount;
+
+	vector<Event> events;
+	queue->copyEvents(events);
+
+	for(unsigned int e = 0; e < events.size(); ++e)
+	{
+		if(events[e].e_type == CONNECTION_REQUEST)
+		{
+			warmSnapshot->requests.push_back(*static_cast<ConnectionRequestEvent*>(events[e].e_data));
+		}
+		else if(events[e].e_type == DESTROY_CONNECTION_PROBE)
+		{
+			DestroyConnectionProbeEvent* dcpe = static_cast<DestroyConnectionProbeEvent*>(events[e].e_data);
+
+			if(dcpe->numberOfHops > 0)
+				continue;
+
+			SnapshotConnection c;
+
+			for(unsigned short int p = 0; p < dcpe->connectionLength; ++p)
+				c.routers.push_back(dcpe->connectionPath[p]->getSourceIndex());
+
+			c.routers.push_back(dcpe->connectionPath[dcpe->connectionLength - 1]->getDestinationIndex());
+			c.wavelength = dcpe->wavelength;
+			c.session = dcpe->session;
+			c.connectionEndTime = events[e].e_time;
+
+			warmSnapshot->connections.push_back(c);
+		}
+	}
+
+	char buffer[100];
+	sprintf(buffer,"Snapshot of %d connections and %d requests at %f.",static_cast<unsigned int>(warmSnapshot->connections.size()),
+		static_cast<unsigned int>(warmSnapshot->requests.size()),warmSnapshot->time);
+	threadZero->recordEvent(buffer,false,controllerIndex);
+
+	resetStats();
+	clearEdgeStats();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	restoreSnapshot
+// Description:		Establishes the connections of the warm state
+//					again and queues its pending requests, in place
+//					of generating the first request of every
+//					workstation.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::restoreSnapshot()
+{
+	trafficCount = warmSnapshot->trafficCount;
+
+	for(unsigned int c = 0; c < warmSnapshot->connections.size(); ++c)
+	{
+		const SnapshotConnection& sc = warmSnapshot->connections[c];
+
+		unsigned short int connectionLength = static_cast<unsigned short int>(sc.routers.size() - 1);
+		Edge** connectionPath = new Edge*[connectionLength];
+
+		for(unsigned short int p = 0; p < connectionLength; ++p)
+		{
+			connectionPath[p] = getRouterAt(sc.routers[p])->getEdgeByDestination(sc.routers[p+1]);
+			connectionPath[p]->setUsed(sc.session,sc.wavelength);
+		}
+
+		Event* event = new Event();
+		DestroyConnectionProbeEvent* dcpe = new DestroyConnectionProbeEvent();
+
+		event->e_type = DESTROY_CONNECTION_PROBE;
+		event->e_time = sc.connectionEndTime;
+		event->e_data = dcpe;
+
+		dcpe->connectionLength = connectionLength;
+		dcpe->connectionPath = connectionPath;
+		dcpe->numberOfHops = 0;
+		dcpe->wavelength = sc.wavelength;
+		dcpe->session = sc.session;
+		dcpe->sequence = 0;
+		dcpe->probes = 0;
+
+		queue->addEvent(*event);
+
+		delete event;
+
+		if(threadZero->getQualityParams().q_factor_stats == true ||
+		   CurrentRoutingAlgorithm == Q_MEASUREMENT || CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+		{
+			addEstablishedConnection(connectionPath,connectionLength,sc.wavelength,sc.connectionEndTime - getGlobalTime());
+		}
+
+		if(CurrentRoutingAlgorithm == Q_MEASUREMENT || CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+			updateQMDegredation(connectionPath,connectionLength,sc.wavelength);
+		else if(threadZero->getQualityParams().q_factor_stats == true)
+			updateQFactorStats(connectionPath,connectionLength,sc.wavelength);
+	}
+
+	for(unsigned int r = 0; r < warmSnapshot->requests.size(); ++r)
+	{
+		Event* tr = new Event();
+		ConnectionRequestEvent* tr_data = new ConnectionRequestEvent(warmSnapshot->requests[r]);
+
+		tr->e_time = tr_data->requestBeginTime;
+		tr->e_type = CONNECTION_REQUEST;
+		tr->e_data = tr_data;
+
+		addTrafficEvent(tr,tr_data);
+	}
+
+	char buffer[100];
+	sprintf(buffer,"Restored %d connections and %d requests.",static_cast<unsigned int>(warmSnapshot->connections.size()),
+		static_cast<unsigned int>(warmSnapshot->requests.size()));
+	threadZero->recordEvent(buffer,false,controllerIndex);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	clearEdgeStats
+// Description:		Clears the Q-factor statistics of all of the
+//					edges.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::clearEdgeStats()
+{
+	for(unsigned short int r = 0; r < getNumberOfRouters(); ++r)
+		for(unsigned short int e = 0; e < getRouterAt(r)->getNumberOfEdges(); ++e)
+			getRouterAt(r)->getEdgeByIndex(e)->resetEdgeStats();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -538,15 +1102,98 @@ void Thread::activate_workstations()
 //
 ///////////////////////////////////////////////////////////////////
 void Thread::deactivate_workstations()
+{
+	reportStats();
+
+	if(traceRecorder != 0)
+	{
+		delete traceRecorder;
+		traceRecorder = 0;
+	}
+
+	for(unsigned short int r1 = 0; r1 < getNumberOfRouters(); ++r1)
+	{
+		for(unsigned short int r2 = 0; r2 < getNumberOfRouters(); ++r2)
+		{
+			Edge* edge = getRouterAt(r1)->getEdgeByDestination(r2);
+
+			if(edge != 0)
+			{
+				for(unsigned short int k = 0; k < threadZero->getNumberOfWavelengths(); ++k)
+				{
+					if(edge->getStatus(k) != EDGE_FREE)
+					{
+						threadZero->recordEvent("ERROR: Edge is still used when all edges should be free.",true,controllerIndex);
+						exit(ERROR_EDGE_IS_USED);
+					}
+				}
+			}
+		}
+	}
+
+	threadZero->recordEvent("Deactivate workstations.",false,controllerIndex);
+
+	for(unsigned short int w = 0; w < getNumberOfWorkstations(); ++w)
+	{
+		if(getWorkstationAt(w)->getActive() == true)
+		{
+			char buffer[50];
+			sprintf(buffer,"\tDeactivate workstation %d",w);
+			threadZero->recordEvent(buffer,false,controllerIndex);
+
+			getWorkstationAt(w)->setActive(false);
+		}
+	}
+
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	reportStats
+// Description:		Prints the statistics of the active workstations
+//					and adds them to the summary over the
+//					replications.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::reportStats()
 {
 	char buffer[200];
+	char job[200];
+
+	//Results kept for the summary over the replications
+	vector<string> resultNames;
+	vector<double> resultValues;
 
 	threadZero->getLogger()->LockResultsMutex();
 
-	sprintf(buffer,"**ALGORITHM = %s-%s, WORKS = %d, PROBE = %s, QA = %d**",threadZero->getRoutingAlgorithmName(CurrentRoutingAlgorithm)->c_str(),
+	sprintf(job,"ALGORITHM = %s-%s, WORKS = %d, PROBE = %s, QA = %d",threadZero->getRoutingAlgorithmName(CurrentRoutingAlgorithm)->c_str(),
 		threadZero->getWavelengthAlgorithmName(CurrentWavelengthAlgorithm)->c_str(),getCurrentActiveWorkstations(),threadZero->getProbeStyleName(CurrentProbeStyle)->c_str(),getCurrentQualityAware());
+
+	if(threadZero->getReplicationStats() != 0)
+		sprintf(buffer,"**%s, REPLICATION = %d**",job,CurrentReplication);
+	else
+		sprintf(buffer,"**%s**",job);
+
 	threadZero->recordEvent(buffer,true,controllerIndex);
 
+	if(CurrentStages > 1)
+	{
+		double stageLength = TEN_HOURS / double(CurrentStages);
+
+		sprintf(buffer,"LOAD STAGE %d OF %d, STATISTICS FROM %f", currentStage + 1, CurrentStages,
+			(double(currentStage) + threadZero->getQualityParams().load_ramp_settle) * stageLength);
+		threadZero->recordEvent(buffer,true,controllerIndex);
+	}
+
+	if(warmSnapshot != 0)
+	{
+		sprintf(buffer,"WARM STATE OF %s-%s, PROBE = %s, QA = %d, STATISTICS FROM %f",
+			threadZero->getRoutingAlgorithmName(warmSnapshot->reference.ra)->c_str(),
+			threadZero->getWavelengthAlgorithmName(warmSnapshot->reference.wa)->c_str(),
+			threadZero->getProbeStyleName(warmSnapshot->reference.ps)->c_str(),warmSnapshot->reference.qa,warmSnapshot->time);
+		threadZero->recordEvent(buffer,true,controllerIndex);
+	}
+
 #ifdef RUN_GUI
 	strcpy(routing,threadZero->getRoutingAlgorithmName(CurrentRoutingAlgorithm)->c_str());
 	strcpy(wavelength,threadZero->getWavelengthAlgorithmName(CurrentWavelengthAlgorithm)->c_str());
@@ -614,6 +1261,110 @@ void Thread::deactivate_workstations()
 		stats.raRunTime / double(stats.ConnectionRequests));
 	threadZero->recordEvent(buffer,true,controllerIndex);
 
+	addResult(resultNames,resultValues,"OVERALL BLOCKING",
+		double(stats.ConnectionRequests - stats.ConnectionSuccesses) / double(stats.ConnectionRequests));
+	addResult(resultNames,resultValues,"COLLISIONS",double(stats.CollisionFailures) / double(stats.ConnectionRequests));
+	addResult(resultNames,resultValues,"BAD QUALITY",double(stats.QualityFailures) / double(stats.ConnectionRequests));
+	addResult(resultNames,resultValues,"NON RESOURCES",double(stats.NoPathFailures) / double(stats.ConnectionRequests));
+	addResult(resultNames,resultValues,"AVERAGE PROBES PER REQUEST",double(stats.ProbeSentCount) / double(stats.ConnectionRequests));
+	addResult(resultNames,resultValues,"AVERAGE REQUEST DELAY TIME",stats.totalSetupDelay / double(stats.ConnectionSuccesses));
+	addResult(resultNames,resultValues,"AVERAGE CONNECTION HOP COUNT",double(stats.totalHopCount) / double(stats.ConnectionSuccesses));
+	addResult(resultNames,resultValues,"AVERAGE CONNECTION SPAN COUNT",double(stats.totalSpanCount) / double(stats.ConnectionSuccesses));
+	addResult(resultNames,resultValues,"AVERAGE ASE NOISE",stats.aseNoiseTotal / double(stats.ConnectionSuccesses));
+	addResult(resultNames,resultValues,"AVERAGE FWM NOISE",stats.fwmNoiseTotal / double(stats.ConnectionSuccesses));
+	addResult(resultNames,resultValues,"AVERAGE XPM NOISE",stats.xpmNoiseTotal / double(stats.ConnectionSuccesses));
+	addResult(resultNames,resultValues,"AVERAGE RA RUN TIME",stats.raRunTime / double(stats.ConnectionRequests));
+
+	if(CurrentRoutingAlgorithm == ACO || CurrentRoutingAlgorithm == MAX_MIN_ACO)
+	{
+		sprintf(buffer,"AVERAGE ACO ITERATIONS (%d/%d) = %f", stats.acoIterations, stats.acoColonies,
+			float(stats.acoIterations) / float(stats.acoColonies));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		sprintf(buffer,"ACO WARM STARTS (%d/%d) = %f", stats.acoWarmStarts, stats.acoColonies,
+			float(stats.acoWarmStarts) / float(stats.acoColonies));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"AVERAGE ACO ITERATIONS",double(stats.acoIterations) / double(stats.acoColonies));
+		addResult(resultNames,resultValues,"ACO WARM STARTS",double(stats.acoWarmStarts) / double(stats.acoColonies));
+	}
+
+	if(CurrentRoutingAlgorithm == Q_MEASUREMENT || CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+	{
+		sprintf(buffer,"QM DEGRADATION SKIPPED (%d/%d) = %f", stats.qmRequested - stats.qmRecalculated, stats.qmRequested,
+			float(stats.qmRequested - stats.qmRecalculated) / float(stats.qmRequested));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"QM DEGRADATION SKIPPED",
+			double(stats.qmRequested - stats.qmRecalculated) / double(stats.qmRequested));
+	}
+
+	if(threadZero->getQualityParams().RA_budget_ops > 0 || threadZero->getQualityParams().RA_budget_time > 0.0)
+	{
+		sprintf(buffer,"RA BUDGET CUTS (%d/%d) = %f", stats.raBudgetCuts, stats.ConnectionRequests,
+			float(stats.raBudgetCuts) / float(stats.ConnectionRequests));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"RA BUDGET CUTS",double(stats.raBudgetCuts) / double(stats.ConnectionRequests));
+	}
+
+	if(speculator != 0)
+	{
+		sprintf(buffer,"SPECULATIVE ROUTES USED (%d/%d) = %f", stats.raSpeculated, stats.ConnectionRequests,
+			float(stats.raSpeculated) / float(stats.ConnectionRequests));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		sprintf(buffer,"SPECULATIVE ROUTE CONFLICTS (%d/%d) = %f", stats.raSpeculationConflicts, stats.ConnectionRequests,
+			float(stats.raSpeculationConflicts) / float(stats.ConnectionRequests));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"SPECULATIVE ROUTES USED",double(stats.raSpeculated) / double(stats.ConnectionRequests));
+		addResult(resultNames,resultValues,"SPECULATIVE ROUTE CONFLICTS",double(stats.raSpeculationConflicts) / double(stats.ConnectionRequests));
+	}
+
+	if(threadZero->getQualityParams().probe_fusion == true)
+	{
+		sprintf(buffer,"FUSED HOP EVENTS PER REQUEST (%d/%d) = %f", stats.fusedHops, stats.ConnectionRequests,
+			float(stats.fusedHops) / float(stats.ConnectionRequests));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"FUSED HOP EVENTS PER REQUEST",double(stats.fusedHops) / double(stats.ConnectionRequests));
+	}
+
+	if(traceRecorder != 0)
+	{
+		sprintf(buffer,"TRACE RECORDED = %d REQUESTS", static_cast<unsigned int>(traceRecorder->getNumberOfRecords()));
+		threadZero->recordEvent(buffer,true,controllerIndex);
+	}
+
+	if(warmup != 0)
+	{
+		if(warmup->getDetected() == true)
+			sprintf(buffer,"WARM UP TRUNCATION (MSER-5) = %d REQUESTS AT %f", warmup->getTruncationRequests(), warmup->getTruncationTime());
+		else
+			sprintf(buffer,"WARM UP TRUNCATION (MSER-5) = NOT DETECTED");
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"WARM UP TRUNCATION TIME",warmup->getTruncationTime());
+	}
+
+	if(batchMeans != 0)
+	{
+		sprintf(buffer,"BATCH MEANS BLOCKING (%d BATCHES) = %f +/- %f", batchMeans->getBatches(),
+			batchMeans->getMean(), batchMeans->getHalfWidth());
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		sprintf(buffer,"BATCH MEANS RELATIVE HALF WIDTH (TARGET %f) = %f", threadZero->getQualityParams().stop_precision,
+			batchMeans->getRelativeHalfWidth());
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		sprintf(buffer,"TRAFFIC STOP TIME (%s) = %f", trafficStopped == true ? "CONVERGED" : "NOT CONVERGED", trafficStopTime);
+		threadZero->recordEvent(buffer,true,controllerIndex);
+
+		addResult(resultNames,resultValues,"BATCH MEANS RELATIVE HALF WIDTH",batchMeans->getRelativeHalfWidth());
+		addResult(resultNames,resultValues,"TRAFFIC STOP TIME",trafficStopTime);
+	}
+
 	if(threadZero->getQualityParams().q_factor_stats == true)
 	{
 		double worstInitQ = std::numeric_limits<float>::infinity();
@@ -630,7 +1381,20 @@ void Thread::deactivate_workstations()
 
 		double timeTotal = 0.0;
 		double countTotal = 0.0;
-		double droppedTotal = 0.0;
+		double droppedTotal = stats.DroppedFailures;
+
+		double variantDropped[MAX_Q_VARIANTS];
+		double variantInitQ[MAX_Q_VARIANTS];
+		double variantAvgQ[MAX_Q_VARIANTS];
+		double variantPerQ[MAX_Q_VARIANTS];
+
+		for(unsigned short int v = 0; v < MAX_Q_VARIANTS; ++v)
+		{
+			variantDropped[v] = stats.variantDroppedFailures[v];
+			variantInitQ[v] = 0.0;
+			variantAvgQ[v] = 0.0;
+			variantPerQ[v] = 0.0;
+		}
 
 		for(unsigned int r = 0; r < threadZero->getNumberOfRouters(); ++r)
 		{
@@ -647,8 +1411,6 @@ void Thread::deactivate_workstations()
 				timeTotal += stats->totalTime;
 				countTotal += stats->count;
 
-				droppedTotal += stats->droppedConnections;
-
 				if(stats->minInitalQFactor < worstInitQ)
 					worstInitQ = stats->minInitalQFactor;
 				else if(stats->maxInitalQFactor > bestInitQ)
@@ -664,6 +1426,13 @@ void Thread::deactivate_workstations()
 				else if(stats->maxPercentQFactor > bestPerQ)
 					bestPerQ = stats->maxPercentQFactor;
 
+				for(unsigned short int v = 0; v < threadZero->getQualityParams().Q_variants; ++v)
+				{
+					variantInitQ[v] += stats->variantInitalQFactor[v];
+					variantAvgQ[v] += stats->variantAverageQFactor[v];
+					variantPerQ[v] += stats->variantPercentQFactor[v];
+				}
+
 				router->getEdgeByIndex(e)->resetEdgeStats();
 			}
 		}
@@ -684,100 +1453,167 @@ void Thread::deactivate_workstations()
 
 		sprintf(buffer,"%% TIME Q BELOW: MIN = %f, MAX = %f, AVG = %f",worstPerQ,bestPerQ,averagePerQ / timeTotal);
 		threadZero->recordEvent(buffer,true,controllerIndex);
-	}
 
-	sprintf(buffer,"***********************************************\n");
-	threadZero->recordEvent(buffer,true,controllerIndex);
+		addResult(resultNames,resultValues,"DROPPED CONNECTIONS",droppedTotal / double(stats.ConnectionRequests));
+		addResult(resultNames,resultValues,"OVERALL W/DROPPED",
+			double(stats.ConnectionRequests - stats.ConnectionSuccesses + droppedTotal) / double(stats.ConnectionRequests));
+		addResult(resultNames,resultValues,"INITIAL Q AVG",averageInitQ / countTotal);
+		addResult(resultNames,resultValues,"AVERAGE Q AVG",averageAvgQ / countTotal);
+		addResult(resultNames,resultValues,"% TIME Q BELOW AVG",averagePerQ / timeTotal);
 
-	threadZero->getLogger()->UnlockResultsMutex();
+		for(unsigned short int v = 0; v < threadZero->getQualityParams().Q_variants; ++v)
+		{
+			sprintf(buffer,"Q VARIANT %d (POWER = %f, GAMMA = %f, NF = %f): DROPPED CONNECTIONS (%d/%d) = %f", v,
+				threadZero->getQualityParams().Q_variant_power[v], threadZero->getQualityParams().Q_variant_gamma[v],
+				threadZero->getQualityParams().Q_variant_noise_figure[v], int(variantDropped[v]), stats.ConnectionRequests,
+				variantDropped[v] / float(stats.ConnectionRequests));
+			threadZero->recordEvent(buffer,true,controllerIndex);
+
+			sprintf(buffer,"Q VARIANT %d: INITIAL Q AVG = %f, AVERAGE Q AVG = %f, %% TIME Q BELOW AVG = %f", v,
+				variantInitQ[v] / countTotal, variantAvgQ[v] / countTotal, variantPerQ[v] / timeTotal);
+			threadZero->recordEvent(buffer,true,controllerIndex);
+
+			char name[50];
+
+			sprintf(name,"Q VARIANT %d DROPPED CONNECTIONS",v);
+			addResult(resultNames,resultValues,name,variantDropped[v] / double(stats.ConnectionRequests));
+			sprintf(name,"Q VARIANT %d AVERAGE Q AVG",v);
+			addResult(resultNames,resultValues,name,variantAvgQ[v] / countTotal);
+			sprintf(name,"Q VARIANT %d %% TIME Q BELOW AVG",v);
+			addResult(resultNames,resultValues,name,variantPerQ[v] / timeTotal);
+		}
+	}
 
-	for(unsigned short int r1 = 0; r1 < getNumberOfRouters(); ++r1)
+	//The whole blocking curve of the load ramp is printed with its last stage
+	if(CurrentStages > 1)
 	{
-		for(unsigned short int r2 = 0; r2 < getNumberOfRouters(); ++r2)
-		{
-			Edge* edge = getRouterAt(r1)->getEdgeByDestination(r2);
+		stageBlocking.push_back(double(stats.ConnectionRequests - stats.ConnectionSuccesses) / double(stats.ConnectionRequests));
 
-			if(edge != 0)
+		if(currentStage + 1 == CurrentStages)
+		{
+			for(unsigned short int s = 0; s < stageBlocking.size(); ++s)
 			{
-				for(unsigned short int k = 0; k < threadZero->getNumberOfWavelengths(); ++k)
-				{
-					if(edge->getStatus(k) != EDGE_FREE)
-					{
-						threadZero->recordEvent("ERROR: Edge is still used when all edges should be free.",true,controllerIndex);
-						exit(ERROR_EDGE_IS_USED);
-					}
-				}
+				sprintf(buffer,"LOAD RAMP: WORKS = %d, OVERALL BLOCKING = %f", (s + 1) * stageWorkstations, stageBlocking[s]);
+				threadZero->recordEvent(buffer,true,controllerIndex);
 			}
 		}
 	}
 
-	threadZero->recordEvent("Deactivate workstations.",false,controllerIndex);
+	sprintf(buffer,"***********************************************\n");
+	threadZero->recordEvent(buffer,true,controllerIndex);
 
-	for(unsigned short int w = 0; w < getNumberOfWorkstations(); ++w)
-	{
-		if(getWorkstationAt(w)->getActive() == true)
-		{
-			char buffer[50];
-			sprintf(buffer,"\tDeactivate workstation %d",w);
-			threadZero->recordEvent(buffer,false,controllerIndex);
+	if(threadZero->getReplicationStats() != 0)
+		threadZero->getReplicationStats()->addReplication(job,resultNames,resultValues,controllerIndex);
 
-			getWorkstationAt(w)->setActive(false);
-		}
-	}
+	threadZero->getLogger()->UnlockResultsMutex();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	generateTrafficEvent
+// Description:		Generates connection request events to setup requests for new
+//					connections.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::generateTrafficEvent(unsigned int session)
+{
+	unsigned int workstation = session / threadZero->getNumberOfConnections();
+
+	boost::uint64_t key = CounterRandom::makeKey(currentSeed,workstation);
+	unsigned int request = trafficCount[workstation]++;
+
+	//The arrival interval and the duration
+	double traffic[2];
+	CounterRandom::generateZeroToOne(key,request,RANDOM_TRAFFIC,0,2,traffic);
 
-	delete rt;
-	delete generateRandomRouter;
+	Event* tr = new Event();
+	ConnectionRequestEvent* tr_data = new ConnectionRequestEvent();
+
+	tr->e_time = getGlobalTime() + float(-threadZero->getQualityParams().arrival_interval * log(traffic[0]));
+	tr->e_type = CONNECTION_REQUEST;
+	tr->e_data = tr_data;
+
+	tr_data->connectionDuration = float(-threadZero->getQualityParams().duration * log(traffic[1]));
+
+	if(tr_data->connectionDuration < threadZero->getMinDuration())
+		tr_data->connectionDuration = threadZero->getMinDuration();
+
+	tr_data->requestBeginTime = tr->e_time;
+	tr_data->sourceRouterIndex = getWorkstationAt(workstation)->getParentRouterIndex();
+	tr_data->destinationRouterIndex = tr_data->sourceRouterIndex;
+	tr_data->session = session;
+	tr_data->sequence = 0;
+	tr_data->max_sequence = 0;
+	tr_data->qualityFail = false;
 
-	delete dt;
-	delete generateRandomDuration;
+	for(unsigned int draw = 0; tr_data->sourceRouterIndex == tr_data->destinationRouterIndex; ++draw)
+	{
+		double p;
+		CounterRandom::generateZeroToOne(key,request,RANDOM_DESTINATION,draw,1,&p);
 
-	delete ai;
-	delete generateArrivalInterval;
+		if(threadZero->getQualityParams().dest_dist == UNIFORM)
+			tr_data->destinationRouterIndex = static_cast<unsigned short int>(p * getNumberOfRouters());
+		else
+			tr_data->destinationRouterIndex = network->generateDestination(tr_data->sourceRouterIndex,p);
+	}
 
-	delete zo;
-	delete generateZeroToOne;
+	addTrafficEvent(tr,tr_data);
 }
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	generateTrafficEvent
-// Description:		Generates connection request events to setup requests for new
-//					connections.
+// Function Name:	replayTrafficEvent
+// Description:		Generates the connection request event of the
+//					next request in the trace.
 //
 ///////////////////////////////////////////////////////////////////
-void Thread::generateTrafficEvent(unsigned int session)
+void Thread::replayTrafficEvent()
 {
-	unsigned int workstation = session / threadZero->getNumberOfConnections();
+	TraceRecord r;
+
+	//Requests after the workstations are deactivated are not counted
+	if(traceReader->next(r) == false || r.arrivalTime >= HUNDRED_HOURS - 1.0)
+		return;
+
+	if(r.arrivalTime < getGlobalTime() || r.sourceRouterIndex >= getNumberOfRouters() ||
+		r.destinationRouterIndex >= getNumberOfRouters() || r.sourceRouterIndex == r.destinationRouterIndex)
+	{
+		threadZero->recordEvent("ERROR: Invalid or unsorted request in the trace!!!",true,controllerIndex);
+		exit(ERROR_TRACE_INPUT);
+	}
 
 	Event* tr = new Event();
 	ConnectionRequestEvent* tr_data = new ConnectionRequestEvent();
 
-	tr->e_time = getGlobalTime() + float((*generateArrivalInterval)());
+	tr->e_time = r.arrivalTime;
 	tr->e_type = CONNECTION_REQUEST;
 	tr->e_data = tr_data;
 
-	tr_data->connectionDuration = float((*generateRandomDuration)());
+	tr_data->connectionDuration = r.holdingTime;
 
 	if(tr_data->connectionDuration < threadZero->getMinDuration())
 		tr_data->connectionDuration = threadZero->getMinDuration();
 
 	tr_data->requestBeginTime = tr->e_time;
-	tr_data->sourceRouterIndex = getWorkstationAt(workstation)->getParentRouterIndex();
-	tr_data->destinationRouterIndex = tr_data->sourceRouterIndex;
-	tr_data->session = session;
+	tr_data->sourceRouterIndex = r.sourceRouterIndex;
+	tr_data->destinationRouterIndex = r.destinationRouterIndex;
+	tr_data->session = traceSession++;
 	tr_data->sequence = 0;
 	tr_data->max_sequence = 0;
 	tr_data->qualityFail = false;
 
-	while(tr_data->sourceRouterIndex == tr_data->destinationRouterIndex)
-	{
-		if(threadZero->getQualityParams().dest_dist == UNIFORM)
-			tr_data->destinationRouterIndex = (*generateRandomRouter)();
-		else if(threadZero->getQualityParams().dest_dist == DISTANCE ||
-				threadZero->getQualityParams().dest_dist == INVERSE_DISTANCE)
-			tr_data->destinationRouterIndex = getRouterAt(tr_data->sourceRouterIndex)->generateDestination((*generateZeroToOne)());
-	}
+	addTrafficEvent(tr,tr_data);
+}
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addTrafficEvent
+// Description:		Adds a connection request event, generated or
+//					replayed, to the event queue.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::addTrafficEvent(Event* tr, ConnectionRequestEvent* tr_data)
+{
 //ifdef RUN_GUI, increment the number of connection attempts FROM the source
 //and increment the number of connection attempts TO the destination
 #ifdef RUN_GUI
@@ -787,6 +1623,9 @@ void Thread::generateTrafficEvent(unsigned int session)
 
 	queue->addEvent(*tr);
 
+	if(speculator != 0)
+		speculator->addRequest(tr->e_time,tr_data);
+
 	delete tr;
 }
 
@@ -796,9 +1635,47 @@ void Thread::generateTrafficEvent(unsigned int session)
 // Description:		Handles a connection request event
 //
 ///////////////////////////////////////////////////////////////////
+template <RoutingAlgorithm RA, ProbeStyle PS>
 void Thread::connection_request(ConnectionRequestEvent* cre)
 {
-	if(getGlobalTime() < TEN_HOURS)
+	if(warmup != 0 && warmup->getDetected() == false && getGlobalTime() < TEN_HOURS)
+	{
+		unsigned int finished = stats.ConnectionSuccesses + stats.CollisionFailures + stats.QualityFailures + stats.NoPathFailures;
+
+		if(warmup->update(finished,finished - stats.ConnectionSuccesses,stats,getGlobalTime()) == true)
+		{
+			truncateStats(warmup->getTruncationStats());
+
+			//The Q-factor averages of the edges are not kept by batch, so they start over here
+			clearEdgeStats();
+
+			finished = stats.ConnectionSuccesses + stats.CollisionFailures + stats.QualityFailures + stats.NoPathFailures;
+
+			if(batchMeans != 0)
+				batchMeans->reset(finished,finished - stats.ConnectionSuccesses);
+		}
+	}
+
+	//The stopping rule only starts once the warm up has been removed
+	if(batchMeans != 0 && trafficStopped == false && getGlobalTime() < TEN_HOURS &&
+		(warmup == 0 || warmup->getDetected() == true))
+	{
+		unsigned int finished = stats.ConnectionSuccesses + stats.CollisionFailures + stats.QualityFailures + stats.NoPathFailures;
+
+		if(batchMeans->update(finished,finished - stats.ConnectionSuccesses) == true)
+		{
+			trafficStopped = true;
+			trafficStopTime = getGlobalTime();
+		}
+	}
+
+	//A trace is replayed to its end, it already holds the requests arriving after ten hours
+	if(threadZero->getQualityParams().trace_mode == TRACE_REPLAY)
+	{
+		if(trafficStopped == false)
+			replayTrafficEvent();
+	}
+	else if(getGlobalTime() < TEN_HOURS && trafficStopped == false)
 	{
 		if((cre->session+1) % threadZero->getNumberOfConnections() != 0)
 			generateTrafficEvent(cre->session+1);
@@ -806,9 +1683,12 @@ void Thread::connection_request(ConnectionRequestEvent* cre)
 			generateTrafficEvent(cre->session + 1 - threadZero->getNumberOfConnections());
 	}
 
+	if(traceRecorder != 0)
+		traceRecorder->record(cre->requestBeginTime,cre->connectionDuration,cre->sourceRouterIndex,cre->destinationRouterIndex);
+
 	++stats.ConnectionRequests;
 
-	if(CurrentRoutingAlgorithm == DYNAMIC_PROGRAMMING || CurrentRoutingAlgorithm  == IMPAIRMENT_AWARE)
+	if((RA == DYNAMIC_PROGRAMMING && threadZero->getQualityParams().DP_alpha < 1.0) || RA == IMPAIRMENT_AWARE)
 	{
 		++stats.ProbeSentCount;
 	}
@@ -817,7 +1697,7 @@ void Thread::connection_request(ConnectionRequestEvent* cre)
 	unsigned short int probeStart = 0;
 	unsigned short int probesSkipped = 0;
 
-	if(CurrentProbeStyle == SINGLE)
+	if(PS == SINGLE)
 		probesToSend = 1;
 	else
 		probesToSend = threadZero->getQualityParams().max_probes;
@@ -836,15 +1716,20 @@ void Thread::connection_request(ConnectionRequestEvent* cre)
 //					connection.
 //
 ///////////////////////////////////////////////////////////////////
+template <RoutingAlgorithm RA, ProbeStyle PS>
 void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 {
+	//A probe leaves the link state alone, so the next routes are calculated meanwhile
+	if(speculator != 0)
+		speculator->schedule();
+
 	++ccpe->numberOfHops;
 
 	if(ccpe->numberOfHops == ccpe->connectionLength)
 	{
 		ccpe->atDestination = true;
 
-		if(CurrentProbeStyle != PARALLEL || sendResponse(ccpe) == true)
+		if(PS != PARALLEL || sendResponse(ccpe) == true)
 		{
 			double q_factor = 0.0;
 			double xpm_noise = 0.0;
@@ -873,7 +1758,7 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 			
 			//Again...some algorithms have to be treated differently because they
 			//use a forward reservation scheme.
-			if(CurrentRoutingAlgorithm == IMPAIRMENT_AWARE || CurrentRoutingAlgorithm == DYNAMIC_PROGRAMMING)
+			if(RA == IMPAIRMENT_AWARE || RA == DYNAMIC_PROGRAMMING)
 			{
 				double q_factor = 0.0;
 				double xpm_noise = 0.0;
@@ -895,17 +1780,17 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 					{
 						q_factor = threadZero->getResourceManager()->estimate_Q(
 							ccpe->wavelength,ccpe->connectionPath,ccpe->connectionLength,&xpm_noise,
-							&fwm_noise,&ase_noise,controllerIndex);
+							&fwm_noise,&ase_noise,context);
 
 						if(getCurrentQualityAware() == true && q_factor < threadZero->getQualityParams().TH_Q)
 							ccpe->wavelength = QUALITY_FAILURE;
 					}
 				}
 
-				if(ccpe->wavelength >= 0 || CurrentRoutingAlgorithm == IMPAIRMENT_AWARE)
+				if(ccpe->wavelength >= 0 || RA == IMPAIRMENT_AWARE)
 				{
 					threadZero->getResourceManager()->print_connection_info(ccpe,q_factor,
-						ase_noise,fwm_noise,xpm_noise,controllerIndex);
+						ase_noise,fwm_noise,xpm_noise,context);
 				}
 				else
 				{
@@ -914,7 +1799,7 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 
 					time(&start);
 
-					ccpe->wavelength = threadZero->getResourceManager()->choose_wavelength(ccpe,controllerIndex);
+					ccpe->wavelength = threadZero->getResourceManager()->choose_wavelength(ccpe,context);
 
 					time(&end);
 					stats.raRunTime += difftime(end,start);
@@ -927,13 +1812,13 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 
 				time(&start);
 
-				ccpe->wavelength = threadZero->getResourceManager()->choose_wavelength(ccpe,controllerIndex);
+				ccpe->wavelength = threadZero->getResourceManager()->choose_wavelength(ccpe,context);
 
 				time(&end);
 				stats.raRunTime += difftime(end,start);
 			}
 		
-			if(CurrentProbeStyle == PARALLEL && ccpe->wavelength == NO_PATH_FAILURE)
+			if(PS == PARALLEL && ccpe->wavelength == NO_PATH_FAILURE)
 			{
 				for(unsigned int p = 0; p < ccce->max_sequence; ++p)
 				{
@@ -944,7 +1829,7 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 					}
 				}
 			}
-			else if(CurrentProbeStyle == SERIAL && ccpe->wavelength == NO_PATH_FAILURE)
+			else if(PS == SERIAL && ccpe->wavelength == NO_PATH_FAILURE)
 			{
 				if(ccpe->qualityFail == true)
 					ccpe->wavelength = QUALITY_FAILURE;
@@ -959,7 +1844,7 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 
 				--ccpe->probes[sequence]->numberOfHops;
 
-				create_connection_probe(ccpe->probes[sequence]);
+				create_connection_probe<RA,PS>(ccpe->probes[sequence]);
 
 				delete ccce;
 			}
@@ -978,7 +1863,7 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 				queue->addEvent(*event);
 			}
 
-			if(CurrentProbeStyle != PARALLEL)
+			if(PS != PARALLEL)
 				delete ccpe;
 			
 			delete event;
@@ -993,6 +1878,9 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 		event->e_time = getGlobalTime() + calculateDelay(ccpe->connectionPath[ccpe->numberOfHops]->getNumberOfSpans());
 		event->e_data = ccpe;
 
+		if(threadZero->getQualityParams().probe_fusion == true)
+			event->e_time = fuseProbeHops(ccpe,event->e_time);
+
 		queue->addEvent(*event);
 
 		delete event;
@@ -1006,21 +1894,22 @@ void Thread::create_connection_probe(CreateConnectionProbeEvent* ccpe)
 //					connection.
 //
 ///////////////////////////////////////////////////////////////////
+template <RoutingAlgorithm RA, ProbeStyle PS>
 void Thread::destroy_connection_probe(DestroyConnectionProbeEvent* dcpe)
 {
 	if(dcpe->numberOfHops == 0)
 	{
-		if(CurrentRoutingAlgorithm == Q_MEASUREMENT || CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+		if(RA == Q_MEASUREMENT || RA == ADAPTIVE_QoS)
 		{
 			for(unsigned int p = 0; p < dcpe->connectionLength; ++p)
-				dcpe->connectionPath[p]->removeEstablishedConnection(dcpe);
+				dcpe->connectionPath[p]->removeEstablishedConnection(context,dcpe);
 
 			updateQMDegredation(dcpe->connectionPath, dcpe->connectionLength, dcpe->wavelength);
 		}
 		else if(threadZero->getQualityParams().q_factor_stats == true)
 		{
 			for(unsigned int p = 0; p < dcpe->connectionLength; ++p)
-				dcpe->connectionPath[p]->removeEstablishedConnection(dcpe);
+				dcpe->connectionPath[p]->removeEstablishedConnection(context,dcpe);
 
 			updateQFactorStats(dcpe->connectionPath, dcpe->connectionLength, dcpe->wavelength);
 		}
@@ -1030,6 +1919,9 @@ void Thread::destroy_connection_probe(DestroyConnectionProbeEvent* dcpe)
 
 	if(edge->getStatus(dcpe->wavelength) == EDGE_USED)
 	{
+		if(speculator != 0)
+			speculator->cancel();
+
 		edge->setFree(dcpe->wavelength);
 	}
 	else
@@ -1073,12 +1965,18 @@ void Thread::destroy_connection_probe(DestroyConnectionProbeEvent* dcpe)
 
 		threadZero->recordEvent(line,false,controllerIndex);
 
-		if(CurrentProbeStyle == PARALLEL)
+		//A connection restored from a warm state has no probes
+		if(PS == PARALLEL && dcpe->probes != 0)
 			clearResponses(dcpe->probes[dcpe->sequence]);
 
 		delete[] dcpe->connectionPath;
 		delete dcpe;
 	}
+	else if(fuseNextHop(getGlobalTime() + calculateDelay(dcpe->connectionPath[dcpe->numberOfHops]->getNumberOfSpans())) == true)
+	{
+		//Nothing else happens before the next hop, so release it right away.
+		destroy_connection_probe<RA,PS>(dcpe);
+	}
 	else
 	{
 		//We are not at our destination yet, so continue with the probe.
@@ -1101,6 +1999,7 @@ void Thread::destroy_connection_probe(DestroyConnectionProbeEvent* dcpe)
 //					connection.
 //
 ///////////////////////////////////////////////////////////////////
+template <RoutingAlgorithm RA, ProbeStyle PS>
 void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* ccce)
 {
 #ifdef RUN_GUI
@@ -1112,6 +2011,9 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 	if(ccce->wavelength >= 0 && edge->getStatus(ccce->wavelength) == EDGE_FREE)
 	{
 		//No collision yet, so reserve the link.
+		if(speculator != 0)
+			speculator->cancel();
+
 		edge->setUsed(ccce->session,ccce->wavelength);
 	}
 	else if(ccce->wavelength >= 0 && edge->getStatus(ccce->wavelength) == EDGE_USED)
@@ -1140,7 +2042,7 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 		cne->sequence = ccce->sequence;
 		cne->probes = ccce->probes;
 
-		if(CurrentProbeStyle == PARALLEL)
+		if(PS == PARALLEL)
 			cne->max_sequence = ccce->probes[ccce->sequence]->max_sequence;
 		else
 			cne->max_sequence = 1;
@@ -1150,7 +2052,7 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 
 		cne->finalFailure = true;
 
-		if(CurrentProbeStyle  == PARALLEL)
+		if(PS == PARALLEL)
 		{
 			for(unsigned int p = 0; p < ccce->probes[ccce->sequence]->max_sequence; ++p)
 			{
@@ -1185,7 +2087,13 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 
 	++ccce->numberOfHops;
 
-	if(ccce->connectionLength > ccce->numberOfHops)
+	if(ccce->connectionLength > ccce->numberOfHops &&
+	   fuseNextHop(getGlobalTime() + calculateDelay(edge->getNumberOfSpans())) == true)
+	{
+		//Nothing else happens before the next hop, so reserve it right away.
+		create_connection_confirmation<RA,PS>(ccce);
+	}
+	else if(ccce->connectionLength > ccce->numberOfHops)
 	{
 		//Forward the confirmation downstream.
 		Event* event = new Event();
@@ -1204,7 +2112,7 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 		{
 			++stats.ConnectionSuccesses;
 
-			if(CurrentRoutingAlgorithm == DYNAMIC_PROGRAMMING || CurrentRoutingAlgorithm  == IMPAIRMENT_AWARE)
+			if((RA == DYNAMIC_PROGRAMMING && threadZero->getQualityParams().DP_alpha < 1.0) || RA == IMPAIRMENT_AWARE)
 			{
 				stats.totalSetupDelay += (threadZero->getResourceManager()->span_distance[ccce->sourceRouterIndex * threadZero->getNumberOfRouters()] * 
 					threadZero->getQualityParams().L * 1000) / (SPEED_OF_LIGHT / threadZero->getQualityParams().refractive_index);
@@ -1242,26 +2150,9 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 			delete event;
 
 			if(threadZero->getQualityParams().q_factor_stats == true ||
-			   CurrentRoutingAlgorithm == Q_MEASUREMENT || CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+			   RA == Q_MEASUREMENT || RA == ADAPTIVE_QoS)
 			{
-				EstablishedConnection* ec = new EstablishedConnection();
-
-				ec->connectionLength = ccce->connectionLength;
-				ec->connectionPath = ccce->connectionPath;
-				ec->wavelength = ccce->wavelength;
-				ec->connectionStartTime = getGlobalTime();
-				ec->connectionEndTime = getGlobalTime() + ccce->connectionDuration;
-
-				if(threadZero->getQualityParams().q_factor_stats == true)
-				{
-					ec->QFactors = new vector<double>;
-					ec->QTimes = new vector<double>;
-				}
-
-				for(unsigned int p = 0; p < ec->connectionLength; ++p)
-				{
-					ec->connectionPath[p]->insertEstablishedConnection(ec);
-				}
+				addEstablishedConnection(ccce->connectionPath,ccce->connectionLength,ccce->wavelength,ccce->connectionDuration);
 			}
 
 			stats.totalHopCount += ccce->connectionLength;
@@ -1271,7 +2162,7 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 				stats.totalSpanCount += ccce->connectionPath[p]->getNumberOfSpans();
 			}
 
-			if(CurrentRoutingAlgorithm == Q_MEASUREMENT || CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+			if(RA == Q_MEASUREMENT || RA == ADAPTIVE_QoS)
 			{
 				updateQMDegredation(ccce->connectionPath, ccce->connectionLength, ccce->wavelength);
 			}
@@ -1280,7 +2171,7 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 				updateQFactorStats(ccce->connectionPath, ccce->connectionLength, ccce->wavelength);
 			}
 
-			if(CurrentProbeStyle == SERIAL && CurrentRoutingAlgorithm != SHORTEST_PATH)
+			if(PS == SERIAL && RA != SHORTEST_PATH)
 			{
 				delete[] ccce->kPaths->pathcost;
 				delete[] ccce->kPaths->pathinfo;
@@ -1291,7 +2182,7 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 
 			delete ccce;
 		}
-		else if(CurrentProbeStyle == SERIAL && ccce->sequence < ccce->max_sequence - 1)
+		else if(PS == SERIAL && ccce->sequence < ccce->max_sequence - 1)
 		{
 			unsigned short int probesToSend = 0;
 			unsigned short int probeStart = 0;
@@ -1324,16 +2215,16 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 		}
 		else if(ccce->wavelength == COLLISION_FAILURE)
 		{			
-			if(CurrentProbeStyle == PARALLEL && ccce->finalFailure == true)
+			if(PS == PARALLEL && ccce->finalFailure == true)
 			{
 				clearResponses(ccce->probes[ccce->sequence]);
 				++stats.CollisionFailures;
 			}
-			else if(CurrentProbeStyle != PARALLEL)
+			else if(PS != PARALLEL)
 			{
 				++stats.CollisionFailures;
 
-				if(CurrentProbeStyle == SERIAL && CurrentRoutingAlgorithm != SHORTEST_PATH)
+				if(PS == SERIAL && RA != SHORTEST_PATH)
 				{
 					delete[] ccce->kPaths->pathcost;
 					delete[] ccce->kPaths->pathinfo;
@@ -1349,19 +2240,19 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 		}
 		else if(ccce->wavelength == QUALITY_FAILURE)
 		{
-			if(CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+			if(RA == ADAPTIVE_QoS)
 			{
 				getRouterAt(ccce->sourceRouterIndex)->incrementQualityFailures();
 			}
 
-			if(CurrentProbeStyle == PARALLEL)
+			if(PS == PARALLEL)
 			{
 				clearResponses(ccce->probes[ccce->sequence]);
 			}
 
 			++stats.QualityFailures;
 
-			if(CurrentProbeStyle == SERIAL && CurrentRoutingAlgorithm != SHORTEST_PATH)
+			if(PS == SERIAL && RA != SHORTEST_PATH)
 			{
 				delete[] ccce->kPaths->pathcost;
 				delete[] ccce->kPaths->pathinfo;
@@ -1375,19 +2266,19 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 		}
 		else if(ccce->wavelength == NO_PATH_FAILURE)
 		{
-			if(CurrentRoutingAlgorithm == ADAPTIVE_QoS)
+			if(RA == ADAPTIVE_QoS)
 			{
 				getRouterAt(ccce->sourceRouterIndex)->incrementWaveFailures();
 			}
 
-			if(CurrentProbeStyle == PARALLEL)
+			if(PS == PARALLEL)
 			{
 				clearResponses(ccce->probes[ccce->sequence]);
 			}
 
 			++stats.NoPathFailures;
 
-			if(CurrentProbeStyle == SERIAL && CurrentRoutingAlgorithm != SHORTEST_PATH)
+			if(PS == SERIAL && RA != SHORTEST_PATH)
 			{
 				delete[] ccce->kPaths->pathcost;
 				delete[] ccce->kPaths->pathinfo;
@@ -1414,12 +2305,16 @@ void Thread::create_connection_confirmation(CreateConnectionConfirmationEvent* c
 //					connection.
 //
 ///////////////////////////////////////////////////////////////////
+template <RoutingAlgorithm RA, ProbeStyle PS>
 void Thread::collision_notification(CollisionNotificationEvent* cne)
 {
 	if(cne->connectionPath[cne->numberOfHops]->getSourceIndex() != cne->sourceRouterIndex)
 	{
 		if(cne->connectionPath[cne->numberOfHops]->getStatus(cne->wavelength) == EDGE_USED)
 		{
+			if(speculator != 0)
+				speculator->cancel();
+
 			cne->connectionPath[cne->numberOfHops]->setFree(cne->wavelength);
 		}
 		else
@@ -1445,7 +2340,7 @@ void Thread::collision_notification(CollisionNotificationEvent* cne)
 
 					--cne->probes[sequence]->numberOfHops;
 
-					create_connection_probe(cne->probes[sequence]);
+					create_connection_probe<RA,PS>(cne->probes[sequence]);
 				}
 			}
 		}
@@ -1453,6 +2348,11 @@ void Thread::collision_notification(CollisionNotificationEvent* cne)
 		delete[] cne->connectionPath;
 		delete cne;
 	}
+	else if(fuseNextHop(getGlobalTime() + calculateDelay(cne->connectionPath[cne->numberOfHops]->getNumberOfSpans())) == true)
+	{
+		//Nothing else happens before the next hop, so release it right away.
+		collision_notification<RA,PS>(cne);
+	}
 	else
 	{
 		Event* event = new Event();
@@ -1467,39 +2367,87 @@ void Thread::collision_notification(CollisionNotificationEvent* cne)
 	}
 }
 
+//Copies of the event handlers, by routing algorithm and then probe style
+#define EVENT_HANDLERS(ra,ps) { &Thread::connection_request<ra,ps>, &Thread::create_connection_probe<ra,ps>, \
+	&Thread::create_connection_confirmation<ra,ps>, &Thread::destroy_connection_probe<ra,ps>, &Thread::collision_notification<ra,ps> }
+
+#define ROUTING_HANDLERS(ra) { EVENT_HANDLERS(ra,SINGLE), EVENT_HANDLERS(ra,SERIAL), EVENT_HANDLERS(ra,PARALLEL) }
+
+const Thread::EventHandlers Thread::eventHandlers[NUMBER_OF_ROUTING_ALGORITHMS][NUMBER_OF_PROBE_STYLES] = {
+	ROUTING_HANDLERS(SHORTEST_PATH),
+	ROUTING_HANDLERS(PABR),
+	ROUTING_HANDLERS(LORA),
+	ROUTING_HANDLERS(IMPAIRMENT_AWARE),
+	ROUTING_HANDLERS(Q_MEASUREMENT),
+	ROUTING_HANDLERS(ADAPTIVE_QoS),
+	ROUTING_HANDLERS(DYNAMIC_PROGRAMMING),
+	ROUTING_HANDLERS(ACO),
+	ROUTING_HANDLERS(MAX_MIN_ACO)
+};
+
+#undef ROUTING_HANDLERS
+#undef EVENT_HANDLERS
+
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	getKthParameterFloat
-// Description:		Gets the kth parameter and returns it as a float.
+// Function Name:	countParameterSets
+// Description:		Counts the sets of quality parameters in the
+//					file, the most values listed by any parameter.
+//					A parameter with fewer values keeps its last
+//					value for the remaining sets.
 //
 ///////////////////////////////////////////////////////////////////
-float Thread::getKthParameterFloat(char* f)
+int Thread::countParameterSets(const char* f)
 {
-	if(strchr(f,',') == 0)
+	int sets = 1;
+
+	char buffer[200];
+
+	ifstream inFile(f);
+
+	while(inFile.getline(buffer,199))
 	{
-		return atof(f);
+		strtok(buffer,"=");
+		char *value = strtok(NULL,"\t");
+
+		if(value == 0)
+			continue;
+
+		int values = 1;
+
+		for(char* c = strchr(value,','); c != 0; c = strchr(c + 1,','))
+			++values;
+
+		if(values > sets)
+			sets = values;
 	}
-	else
-	{
-		char* token = strtok(f,",");
-		float retVal;
-		int t = 0;
 
-		while(token != 0)
-		{
-			if(t == runCount)
-				retVal = atof(token);
+	inFile.close();
 
-			token = strtok(NULL,",");
+	return sets;
+}
 
-			if(t > maxRunCount)
-				maxRunCount = t;
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getKthParameterFloat
+// Description:		Gets the kth parameter and returns it as a float.
+//
+///////////////////////////////////////////////////////////////////
+float Thread::getKthParameterFloat(char* f)
+{
+	char* token = strtok(f,",");
+	float retVal = 0.0;
+	int t = 0;
 
-			++t;
-		}
+	while(token != 0 && t <= runCount)
+	{
+		retVal = static_cast<float>(atof(token));
 
-		return retVal;
+		token = strtok(NULL,",");
+		++t;
 	}
+
+	return retVal;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -1510,30 +2458,51 @@ float Thread::getKthParameterFloat(char* f)
 ///////////////////////////////////////////////////////////////////
 int Thread::getKthParameterInt(char* f)
 {
-	if(strchr(f,',') == 0)
+	char* token = strtok(f,",");
+	int retVal = 0;
+	int t = 0;
+
+	while(token != 0 && t <= runCount)
 	{
-		return atoi(f);
+		retVal = atoi(token);
+
+		token = strtok(NULL,",");
+		++t;
 	}
-	else
-	{
-		char* token = strtok(f,",");
-		int retVal;
-		int t = 0;
 
-		while(token != 0)
-		{
-			if(t == runCount)
-				retVal = atoi(f);
+	return retVal;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	getKthParameterList
+// Description:		Gets the kth parameter as a list of floats split
+//					by semicolons and returns the number of values.
+//
+///////////////////////////////////////////////////////////////////
+unsigned short int Thread::getKthParameterList(char* f, float* list)
+{
+	char* set = f;
 
-			++t;
-			token = strtok(NULL,",");
+	for(int t = 0; t < runCount && strchr(set,',') != 0; ++t)
+		set = strchr(set,',') + 1;
 
-			if(t > maxRunCount)
-				maxRunCount = t;
-		}
+	if(strchr(set,',') != 0)
+		*strchr(set,',') = '\0';
+
+	unsigned short int n = 0;
 
-		return retVal;
+	for(char* v = set; v != 0 && n < MAX_Q_VARIANTS; ++n)
+	{
+		list[n] = static_cast<float>(atof(v));
+
+		v = strchr(v,';');
+
+		if(v != 0)
+			++v;
 	}
+
+	return n;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -1548,6 +2517,56 @@ void Thread::setQualityParameters(const char* f)
 	//Default setting is uniform. Can be modifed using the parameter file.
 	qualityParams.dest_dist = UNIFORM;
 
+	//Default setting is to build the ants on the simulation thread only.
+	qualityParams.ACO_threads = 1;
+
+	//Default setting is a fresh colony for every request.
+	qualityParams.ACO_warm_start = false;
+	qualityParams.ACO_warm_interval = 0.0;
+	qualityParams.ACO_stable_iter = 0;
+
+	//Default setting is to estimate the Q-factors on the simulation thread only.
+	qualityParams.Q_threads = 1;
+
+	//Default setting is no speculative route calculation.
+	qualityParams.RA_speculate = 0;
+
+	//Default setting is one event for every hop of a signaling message.
+	qualityParams.probe_fusion = false;
+
+	//Default setting is no compute budget for the routing algorithms.
+	qualityParams.RA_budget_ops = 0;
+	qualityParams.RA_budget_time = 0.0;
+
+	//Default setting is a single run of every simulation.
+	qualityParams.replications = 1;
+
+	//Default setting is the full ten hours of traffic in every simulation.
+	qualityParams.stop_precision = 0.0;
+	qualityParams.stop_batch_size = 1000;
+	qualityParams.stop_min_batches = 10;
+
+	//Default setting is statistics from the start of every simulation.
+	qualityParams.warmup_detect = false;
+	qualityParams.warmup_check = 50;
+
+	//Default setting is a separate simulation for every number of workstations.
+	qualityParams.load_ramp = false;
+	qualityParams.load_ramp_settle = 0.2;
+
+	//Default setting is every algorithm starting from an empty network.
+	qualityParams.warm_fork = false;
+	qualityParams.warm_fork_settle = 0.2;
+
+	//Default setting is generated traffic that is not recorded.
+	qualityParams.trace_mode = TRACE_OFF;
+
+	//Default setting is no physical parameter variants.
+	qualityParams.Q_variants = 0;
+	unsigned short int variantPowers = 0;
+	unsigned short int variantGammas = 0;
+	unsigned short int variantNoiseFigures = 0;
+
 	char buffer[200];
 	sprintf(buffer,"Reading Quality Parameters from %s file.",f);
 	threadZero->recordEvent(buffer,true,0);
@@ -1727,6 +2746,8 @@ void Thread::setQualityParameters(const char* f)
 				qualityParams.dest_dist = DISTANCE;
 			else if(getKthParameterInt(value) == 3)
 				qualityParams.dest_dist = INVERSE_DISTANCE;
+			else if(getKthParameterInt(value) == 4)
+				qualityParams.dest_dist = TRAFFIC_MATRIX;
 			else
 			{
 				sprintf(buffer,"Unexpected value input for dest_dist.");
@@ -1755,34 +2776,256 @@ void Thread::setQualityParameters(const char* f)
 			sprintf(buffer,"\tACO_alpha = %f",qualityParams.ACO_alpha);
 			threadZero->recordEvent(buffer,true,0);
 		}
-		else if(strcmp(param,"ACO_beta") == 0)
+		else if(strcmp(param,"ACO_beta") == 0)
+		{
+			qualityParams.ACO_beta = getKthParameterFloat(value);
+			sprintf(buffer,"\tACO_beta = %f",qualityParams.ACO_beta);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"ACO_rho") == 0)
+		{
+			qualityParams.ACO_rho = getKthParameterFloat(value);
+			sprintf(buffer,"\tACO_rho = %f",qualityParams.ACO_rho);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"MM_ACO_gamma") == 0)
+		{
+			qualityParams.MM_ACO_gamma = getKthParameterFloat(value);
+			sprintf(buffer,"\tMM_ACO_gamma = %f",qualityParams.MM_ACO_gamma);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"MM_ACO_N_iter") == 0)
+		{
+			qualityParams.MM_ACO_N_iter = getKthParameterInt(value);
+			sprintf(buffer,"\tMM_ACO_N_iter = %d",qualityParams.MM_ACO_N_iter);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"MM_ACO_N_reset") == 0)
+		{
+			qualityParams.MM_ACO_N_reset = getKthParameterInt(value);
+			sprintf(buffer,"\tMM_ACO_N_reset = %d",qualityParams.MM_ACO_N_reset);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"ACO_threads") == 0)
+		{
+			qualityParams.ACO_threads = getKthParameterInt(value);
+			sprintf(buffer,"\tACO_threads = %d",qualityParams.ACO_threads);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"Q_threads") == 0)
+		{
+			qualityParams.Q_threads = getKthParameterInt(value);
+			sprintf(buffer,"\tQ_threads = %d",qualityParams.Q_threads);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"RA_speculate") == 0)
+		{
+			qualityParams.RA_speculate = getKthParameterInt(value);
+			sprintf(buffer,"\tRA_speculate = %d",qualityParams.RA_speculate);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"probe_fusion") == 0)
+		{
+			if(getKthParameterInt(value) == 1)
+				qualityParams.probe_fusion = true;
+			else if(getKthParameterInt(value) == 0)
+				qualityParams.probe_fusion = false;
+			else
+			{
+				sprintf(buffer,"Unexpected value input for probe_fusion.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.probe_fusion = false;
+			}
+
+			sprintf(buffer,"\tprobe_fusion = %d",qualityParams.probe_fusion);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"ACO_warm_start") == 0)
+		{
+			if(getKthParameterInt(value) == 1)
+				qualityParams.ACO_warm_start = true;
+			else if(getKthParameterInt(value) == 0)
+				qualityParams.ACO_warm_start = false;
+			else
+			{
+				sprintf(buffer,"Unexpected value input for ACO_warm_start.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.ACO_warm_start = false;
+			}
+
+			sprintf(buffer,"\tACO_warm_start = %d",qualityParams.ACO_warm_start);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"ACO_warm_interval") == 0)
+		{
+			qualityParams.ACO_warm_interval = getKthParameterFloat(value);
+			sprintf(buffer,"\tACO_warm_interval = %f",qualityParams.ACO_warm_interval);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"ACO_stable_iter") == 0)
+		{
+			qualityParams.ACO_stable_iter = getKthParameterInt(value);
+			sprintf(buffer,"\tACO_stable_iter = %d",qualityParams.ACO_stable_iter);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"RA_budget_ops") == 0)
+		{
+			qualityParams.RA_budget_ops = getKthParameterInt(value);
+			sprintf(buffer,"\tRA_budget_ops = %d",qualityParams.RA_budget_ops);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"RA_budget_time") == 0)
+		{
+			qualityParams.RA_budget_time = getKthParameterFloat(value);
+			sprintf(buffer,"\tRA_budget_time = %f",qualityParams.RA_budget_time);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"replications") == 0)
+		{
+			qualityParams.replications = getKthParameterInt(value);
+			sprintf(buffer,"\treplications = %d",qualityParams.replications);
+			threadZero->recordEvent(buffer,true,0);
+
+			if(qualityParams.replications < 1)
+				qualityParams.replications = 1;
+		}
+		else if(strcmp(param,"stop_precision") == 0)
+		{
+			qualityParams.stop_precision = getKthParameterFloat(value);
+			sprintf(buffer,"\tstop_precision = %f",qualityParams.stop_precision);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"stop_batch_size") == 0)
+		{
+			qualityParams.stop_batch_size = getKthParameterInt(value);
+			sprintf(buffer,"\tstop_batch_size = %d",qualityParams.stop_batch_size);
+			threadZero->recordEvent(buffer,true,0);
+
+			if(qualityParams.stop_batch_size < 1)
+				qualityParams.stop_batch_size = 1;
+		}
+		else if(strcmp(param,"stop_min_batches") == 0)
+		{
+			qualityParams.stop_min_batches = getKthParameterInt(value);
+			sprintf(buffer,"\tstop_min_batches = %d",qualityParams.stop_min_batches);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"warmup_detect") == 0)
+		{
+			if(getKthParameterInt(value) == 1)
+				qualityParams.warmup_detect = true;
+			else if(getKthParameterInt(value) == 0)
+				qualityParams.warmup_detect = false;
+			else
+			{
+				sprintf(buffer,"Unexpected value input for warmup_detect.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.warmup_detect = false;
+			}
+
+			sprintf(buffer,"\twarmup_detect = %d",qualityParams.warmup_detect);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"warmup_check") == 0)
+		{
+			qualityParams.warmup_check = getKthParameterInt(value);
+			sprintf(buffer,"\twarmup_check = %d",qualityParams.warmup_check);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"load_ramp") == 0)
+		{
+			if(getKthParameterInt(value) == 1)
+				qualityParams.load_ramp = true;
+			else if(getKthParameterInt(value) == 0)
+				qualityParams.load_ramp = false;
+			else
+			{
+				sprintf(buffer,"Unexpected value input for load_ramp.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.load_ramp = false;
+			}
+
+			sprintf(buffer,"\tload_ramp = %d",qualityParams.load_ramp);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"load_ramp_settle") == 0)
+		{
+			qualityParams.load_ramp_settle = getKthParameterFloat(value);
+
+			if(qualityParams.load_ramp_settle < 0.0 || qualityParams.load_ramp_settle >= 1.0)
+			{
+				sprintf(buffer,"Unexpected value input for load_ramp_settle.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.load_ramp_settle = 0.2;
+			}
+
+			sprintf(buffer,"\tload_ramp_settle = %f",qualityParams.load_ramp_settle);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"warm_fork") == 0)
+		{
+			if(getKthParameterInt(value) == 1)
+				qualityParams.warm_fork = true;
+			else if(getKthParameterInt(value) == 0)
+				qualityParams.warm_fork = false;
+			else
+			{
+				sprintf(buffer,"Unexpected value input for warm_fork.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.warm_fork = false;
+			}
+
+			sprintf(buffer,"\twarm_fork = %d",qualityParams.warm_fork);
+			threadZero->recordEvent(buffer,true,0);
+		}
+		else if(strcmp(param,"warm_fork_settle") == 0)
 		{
-			qualityParams.ACO_beta = getKthParameterFloat(value);
-			sprintf(buffer,"\tACO_beta = %f",qualityParams.ACO_beta);
+			qualityParams.warm_fork_settle = getKthParameterFloat(value);
+
+			if(qualityParams.warm_fork_settle < 0.0 || qualityParams.warm_fork_settle >= 1.0)
+			{
+				sprintf(buffer,"Unexpected value input for warm_fork_settle.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.warm_fork_settle = 0.2;
+			}
+
+			sprintf(buffer,"\twarm_fork_settle = %f",qualityParams.warm_fork_settle);
 			threadZero->recordEvent(buffer,true,0);
 		}
-		else if(strcmp(param,"ACO_rho") == 0)
+		else if(strcmp(param,"trace_mode") == 0)
 		{
-			qualityParams.ACO_rho = getKthParameterFloat(value);
-			sprintf(buffer,"\tACO_rho = %f",qualityParams.ACO_rho);
+			if(getKthParameterInt(value) == 0)
+				qualityParams.trace_mode = TRACE_OFF;
+			else if(getKthParameterInt(value) == 1)
+				qualityParams.trace_mode = TRACE_RECORD;
+			else if(getKthParameterInt(value) == 2)
+				qualityParams.trace_mode = TRACE_REPLAY;
+			else
+			{
+				sprintf(buffer,"Unexpected value input for trace_mode.");
+				threadZero->recordEvent(buffer,true,0);
+				qualityParams.trace_mode = TRACE_OFF;
+			}
+
+			sprintf(buffer,"\ttrace_mode = %d",qualityParams.trace_mode);
 			threadZero->recordEvent(buffer,true,0);
 		}
-		else if(strcmp(param,"MM_ACO_gamma") == 0)
+		else if(strcmp(param,"Q_variant_power") == 0)
 		{
-			qualityParams.MM_ACO_gamma = getKthParameterFloat(value);
-			sprintf(buffer,"\tMM_ACO_gamma = %f",qualityParams.MM_ACO_gamma);
+			variantPowers = getKthParameterList(value,qualityParams.Q_variant_power);
+			sprintf(buffer,"\tQ_variant_power = %d values",variantPowers);
 			threadZero->recordEvent(buffer,true,0);
 		}
-		else if(strcmp(param,"MM_ACO_N_iter") == 0)
+		else if(strcmp(param,"Q_variant_gamma") == 0)
 		{
-			qualityParams.MM_ACO_N_iter = getKthParameterInt(value);
-			sprintf(buffer,"\tMM_ACO_N_iter = %d",qualityParams.MM_ACO_N_iter);
+			variantGammas = getKthParameterList(value,qualityParams.Q_variant_gamma);
+			sprintf(buffer,"\tQ_variant_gamma = %d values",variantGammas);
 			threadZero->recordEvent(buffer,true,0);
 		}
-		else if(strcmp(param,"MM_ACO_N_reset") == 0)
+		else if(strcmp(param,"Q_variant_noise_figure") == 0)
 		{
-			qualityParams.MM_ACO_N_reset = getKthParameterInt(value);
-			sprintf(buffer,"\tMM_ACO_N_reset = %d",qualityParams.MM_ACO_N_reset);
+			variantNoiseFigures = getKthParameterList(value,qualityParams.Q_variant_noise_figure);
+			sprintf(buffer,"\tQ_variant_noise_figure = %d values",variantNoiseFigures);
 			threadZero->recordEvent(buffer,true,0);
 		}
 		else
@@ -1793,6 +3036,62 @@ void Thread::setQualityParameters(const char* f)
 		}
 	}
 
+	//The kept pheromone evaporates once per arrival interval unless specified.
+	if(qualityParams.ACO_warm_interval <= 0.0)
+		qualityParams.ACO_warm_interval = qualityParams.arrival_interval;
+
+	//The settling window of every load stage takes the place of the warm up removal and the
+	//stopping rule, and a replayed trace already fixes the workstations making the requests
+	if(qualityParams.load_ramp == true)
+	{
+		if(qualityParams.trace_mode == TRACE_REPLAY)
+		{
+			threadZero->recordEvent("load_ramp is ignored when a trace is replayed.",true,0);
+			qualityParams.load_ramp = false;
+		}
+		else
+		{
+			qualityParams.warmup_detect = false;
+			qualityParams.stop_precision = 0.0;
+		}
+	}
+
+	//The snapshot replaces the warm up of the other algorithms in the same way. A trace is
+	//read and written from its start, so it cannot be continued from a snapshot.
+	if(qualityParams.warm_fork == true)
+	{
+		if(qualityParams.load_ramp == true || qualityParams.trace_mode != TRACE_OFF)
+		{
+			threadZero->recordEvent("warm_fork is ignored with load_ramp or a trace.",true,0);
+			qualityParams.warm_fork = false;
+		}
+		else
+		{
+			qualityParams.warmup_detect = false;
+			qualityParams.stop_precision = 0.0;
+		}
+	}
+
+	//A variant takes the value of the simulation for the parameters it does not list
+	qualityParams.Q_variants = variantPowers;
+
+	if(variantGammas > qualityParams.Q_variants)
+		qualityParams.Q_variants = variantGammas;
+
+	if(variantNoiseFigures > qualityParams.Q_variants)
+		qualityParams.Q_variants = variantNoiseFigures;
+
+	fillVariants(qualityParams.Q_variant_power,variantPowers,qualityParams.Q_variants,qualityParams.channel_power);
+	fillVariants(qualityParams.Q_variant_gamma,variantGammas,qualityParams.Q_variants,qualityParams.gamma);
+	fillVariants(qualityParams.Q_variant_noise_figure,variantNoiseFigures,qualityParams.Q_variants,qualityParams.EDFA_Noise_Figure);
+
+	for(unsigned short int v = 0; v < qualityParams.Q_variants; ++v)
+	{
+		sprintf(buffer,"\tQ variant %d: channel_power = %f, gamma = %f, EDFA_Noise_Figure = %f",v,
+			qualityParams.Q_variant_power[v],qualityParams.Q_variant_gamma[v],qualityParams.Q_variant_noise_figure[v]);
+		threadZero->recordEvent(buffer,true,0);
+	}
+
 	qualityParams.ASE_perEDFA = new float[getNumberOfWavelengths()];
 
 	for(unsigned int w = 0; w < getNumberOfWavelengths(); ++w)
@@ -1826,150 +3125,70 @@ void Thread::setQualityParameters(const char* f)
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	setTopologyParameters
-// Description:		Opens up the Topology Paremeters file that was
-//					specified by the command line arguement
+// Function Name:	buildNetwork
+// Description:		Builds the routers, edges and workstations of the
+//					thread from the shared topology, along with the
+//					link state of all of the edges.
 //
 ///////////////////////////////////////////////////////////////////
-void Thread::setTopologyParameters(const char * f)
+void Thread::buildNetwork()
 {
-	char buffer[200];
-	sprintf(buffer,"Reading Topology Parameters from %s file.",f);
-	threadZero->recordEvent(buffer,false,0);
+	numberOfRouters = network->getNumberOfRouters();
+	numberOfEdges = network->getNumberOfEdges();
+	numberOfWorkstations = network->getNumberOfWorkstations();
 
-#ifdef RUN_GUI
-	strcpy(topoFile,f);
-#endif
-
-	ifstream inFile(f);
-
-	char *param;
-		
-	numberOfRouters = 0;
-	numberOfEdges = 0;
-
-	while(inFile.getline(buffer,199))
+	for(unsigned short int r = 0; r < numberOfRouters; ++r)
 	{
-		param = strtok(buffer,"=");
-
-		if(strcmp(param,"Router") == 0)
-		{
-			Router* r = new Router;
+		Router* router = new Router;
 
-			r->setIndex(numberOfRouters);
+		router->setIndex(r);
 
 #ifdef RUN_GUI
-			r->setXPercent(atoi(strtok(NULL,",")));
-			r->setYPercent(atoi(strtok(NULL,",")));
+		router->setXPercent(network->getRouterXPercent(r));
+		router->setYPercent(network->getRouterYPercent(r));
 #endif
-			addRouter(r);
+		addRouter(router);
+	}
 
-			++numberOfRouters;
-		}
-		else if(strcmp(param,"Edge") == 0)
-		{
-			unsigned short int from = atoi(strtok(NULL,","));
-			unsigned short int to = atoi(strtok(NULL,","));
-			unsigned short int spans = atoi(strtok(NULL,","));
+	//All wavelengths of all edges are kept in one block, one row per edge
+	linkState = new int[numberOfEdges * threadZero->getNumberOfWavelengths()];
 
-			Edge* e1 = new Edge(from,to,spans);
-			Edge* e2 = new Edge(to,from,spans);
+	for(unsigned short int e = 0; e < numberOfEdges; ++e)
+	{
+		Edge* edge = new Edge(network->getEdgeSource(e),network->getEdgeDestination(e),network->getEdgeSpans(e),e);
 
-			getRouterAt(from)->addEdge(e1);
-			getRouterAt(to)->addEdge(e2);
+		edge->setLinkState(&linkState[e * threadZero->getNumberOfWavelengths()]);
 
-			numberOfEdges += 2;
-		}
-		else
-		{
-			threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
-			inFile.close();
-			exit(ERROR_TOPOLOGY_INPUT_EDGES);
-		}
+		getRouterAt(network->getEdgeSource(e))->addEdge(edge);
 	}
 
-	sprintf(buffer,"\tCreated %d routers.",numberOfRouters);
-	threadZero->recordEvent(buffer,false,0);
+	for(unsigned short int w = 0; w < numberOfWorkstations; ++w)
+	{
+		Workstation* workstation = new Workstation();
 
-	sprintf(buffer,"\tCreated %d edges.",numberOfEdges);
-	threadZero->recordEvent(buffer,false,0);
+		workstation->setParentRouterIndex(network->getWorkstationParent(w));
 
-	inFile.close();
+		addWorkstation(workstation);
+	}
 }
 
 ///////////////////////////////////////////////////////////////////
 //
-// Function Name:	setWorkstationParameters
-// Description:		Opens up the Workstation Paremeters file that was
-//					specified by the command line arguement
+// Function Name:	deleteAlgorithmNames
+// Description:		Deletes the names of the algorithms created by
+//					setAlgorithmParameters.
 //
 ///////////////////////////////////////////////////////////////////
-void Thread::setWorkstationParameters(const char * f)
+void Thread::deleteAlgorithmNames()
 {
-	char buffer[200];
-	sprintf(buffer,"Reading Workstation Parameters from %s file.",f);
-	threadZero->recordEvent(buffer,false,0);
-
-#ifdef RUN_GUI
-	strcpy(wkstFile,f);
-#endif
-
-	ifstream inFile(f);
-
-	inFile.getline(buffer,199);
-
-	char *param;
-	char *parent;
-	char *traffic;
-		
-	param = strtok(buffer,"=");
-	parent = strtok(NULL," ,\t");
-
-	if(strcmp(param,"NumberOfWorkstations") == 0)
-		numberOfWorkstations = atoi(parent);
-	else
-	{
-		threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
-		exit(ERROR_WORKSTATION_INPUT_QUANTITY);
-	}
-
-	//Add the specific configuration of workstations, if specified.
-	while(inFile.getline(buffer,199))
-	{
-		Workstation* w = new Workstation();
-
-		param = strtok(buffer,"=");
-		parent = strtok(NULL," ,\t");
-		traffic = strtok(NULL," ,\t");
-
-		if(strcmp(param,"Workstation") == 0)
-		{
-			w->setParentRouterIndex(atoi(parent));
-		}
-		else
-		{
-			threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
-			inFile.close();
-			exit(ERROR_WORKSTATION_INPUT_PARENT);
-		}
-
-		addWorkstation(w);
-	}
+	for(unsigned short int a = 0; a < NUMBER_OF_ROUTING_ALGORITHMS; ++a)
+		delete RoutingAlgorithmNames[a];
 
-	//If workstations are not specified, then just uniformly distribute them amongst the routers.
-	for(unsigned short int n = static_cast<unsigned short int>(workstations.size()); n < numberOfWorkstations; ++n)
-	{
-		Workstation* w = new Workstation();
-
-		w->setParentRouterIndex(n % getNumberOfRouters());
-
-		addWorkstation(w);
-	}
+	for(unsigned short int w = 0; w < NUMBER_OF_WAVELENGTH_ALGORITHMS; ++w)
+		delete WavelengthAlgorithmNames[w];
 
-	inFile.close();
-
-	sprintf(buffer,"\tCreated %d workstations.",numberOfWorkstations);
-	threadZero->recordEvent(buffer,false,0);
+	for(unsigned short int p = 0; p < NUMBER_OF_PROBE_STYLES; ++p)
+		delete ProbeStyleNames[p];
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -2007,6 +3226,13 @@ void Thread::setAlgorithmParameters(const char * f, unsigned short int iteration
 	ProbeStyleNames[SERIAL] = new std::string("SERIAL");
 	ProbeStyleNames[PARALLEL] = new std::string("PARALLEL");
 
+	for(unsigned short int a = 0; a < forkAlgorithms.size(); ++a)
+		delete forkAlgorithms[a];
+
+	forkAlgorithms.clear();
+
+	bool firstAlgorithm = true;
+
 	char buffer[200];
 	sprintf(buffer,"Reading Algorithm Parameters from %s file.",f);
 	threadZero->recordEvent(buffer,false,0);
@@ -2071,23 +3297,57 @@ void Thread::setAlgorithmParameters(const char * f, unsigned short int iteration
 				threadZero->recordEvent("ERROR: Invalid line in the input file!!!",true,0);
 				exit(ERROR_ALGORITHM_INPUT);
 			}
+			else if(qualityParams.warm_fork == true && firstAlgorithm == false)
+			{
+				//Run by the jobs of the first algorithm, from its warm state
+				AlgorithmToRun* ap = new AlgorithmToRun;
+
+				ap->ra = CurrentRoutingAlgorithm;
+				ap->wa = CurrentWavelengthAlgorithm;
+				ap->ps = CurrentProbeStyle;
+				ap->qa = CurrentQualityAware;
+				ap->workstations = 0;
+				ap->replication = 0;
+				ap->stages = 1;
+				ap->warmFork = false;
+
+				forkAlgorithms.push_back(ap);
+			}
 			else
 			{
 				unsigned short int iterationWorkstationDelta = static_cast<unsigned short int>(float(1.0) / float(iterationCount) *
 					float(threadZero->getNumberOfWorkstations()));
 
-				for(unsigned short int i = 0; i < iterationCount; ++i)
-				{
-					AlgorithmToRun* ap = new AlgorithmToRun;
+				//The iterations are the stages of a single simulation for the load ramp
+				unsigned short int simulations = iterationCount;
+				unsigned short int stages = 1;
 
-					ap->ra = CurrentRoutingAlgorithm;
-					ap->wa = CurrentWavelengthAlgorithm;
-					ap->ps = CurrentProbeStyle;
-					ap->qa = CurrentQualityAware;
-					ap->workstations = (i + 1) * iterationWorkstationDelta;
+				if(qualityParams.load_ramp == true && iterationCount > 1)
+				{
+					simulations = 1;
+					stages = iterationCount;
+				}
 
-					algParams.push_back(ap);
+				for(unsigned short int i = 0; i < simulations; ++i)
+				{
+					for(unsigned short int r = 0; r < qualityParams.replications; ++r)
+					{
+						AlgorithmToRun* ap = new AlgorithmToRun;
+
+						ap->ra = CurrentRoutingAlgorithm;
+						ap->wa = CurrentWavelengthAlgorithm;
+						ap->ps = CurrentProbeStyle;
+						ap->qa = CurrentQualityAware;
+						ap->workstations = (i + 1) * iterationWorkstationDelta;
+						ap->replication = r;
+						ap->stages = stages;
+						ap->warmFork = qualityParams.warm_fork;
+
+						algParams.push_back(ap);
+					}
 				}
+
+				firstAlgorithm = false;
 			}
 		}
 	}
@@ -2095,6 +3355,49 @@ void Thread::setAlgorithmParameters(const char * f, unsigned short int iteration
 	inFile.close();
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	truncateStats
+// Description:		Removes the statistics collected up to the end
+//					of the warm up from the current statistics.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::truncateStats(const GlobalStats &base)
+{
+	stats.ConnectionRequests -= base.ConnectionRequests;
+	stats.ConnectionSuccesses -= base.ConnectionSuccesses;
+	stats.CollisionFailures -= base.CollisionFailures;
+	stats.QualityFailures -= base.QualityFailures;
+	stats.NoPathFailures -= base.NoPathFailures;
+	stats.DroppedFailures -= base.DroppedFailures;
+	stats.ProbeSentCount -= base.ProbeSentCount;
+	stats.totalHopCount -= base.totalHopCount;
+	stats.totalSpanCount -= base.totalSpanCount;
+
+	stats.aseNoiseTotal -= base.aseNoiseTotal;
+	stats.xpmNoiseTotal -= base.xpmNoiseTotal;
+	stats.fwmNoiseTotal -= base.fwmNoiseTotal;
+	stats.totalSetupDelay -= base.totalSetupDelay;
+	stats.raRunTime -= base.raRunTime;
+
+	stats.acoColonies -= base.acoColonies;
+	stats.acoIterations -= base.acoIterations;
+	stats.acoWarmStarts -= base.acoWarmStarts;
+
+	stats.raBudgetCuts -= base.raBudgetCuts;
+
+	stats.raSpeculated -= base.raSpeculated;
+	stats.raSpeculationConflicts -= base.raSpeculationConflicts;
+
+	stats.fusedHops -= base.fusedHops;
+
+	stats.qmRequested -= base.qmRequested;
+	stats.qmRecalculated -= base.qmRecalculated;
+
+	for(unsigned short int v = 0; v < MAX_Q_VARIANTS; ++v)
+		stats.variantDroppedFailures[v] -= base.variantDroppedFailures[v];
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	update_link_usage
@@ -2114,6 +3417,9 @@ void Thread::update_link_usage()
 		return;
 	}
 
+	if(speculator != 0)
+		speculator->cancel();
+
 	for(unsigned short int r = 0; r < getNumberOfRouters(); ++r)
 	{
 		getRouterAt(r)->updateUsage();
@@ -2149,68 +3455,102 @@ kShortestPathReturn* Thread::getKShortestPaths(ConnectionRequestEvent *cre, unsi
 
 	time(&start);
 
+	startRouteBudget();
+
+	kPath = 0;
+
+	if(speculator != 0)
+	{
+		bool conflict = false;
+
+		kPath = speculator->takeRoute(getGlobalTime(),cre,conflict);
+
+		if(kPath != 0)
+			++stats.raSpeculated;
+		else if(conflict == true)
+			++stats.raSpeculationConflicts;
+
+		//The helpers move on to the next requests while this one is calculated
+		speculator->schedule();
+	}
+
+	if(kPath == 0)
+		kPath = calculatePaths(cre->sourceRouterIndex,cre->destinationRouterIndex,probesToSend,context);
+
+	stopRouteBudget();
+
+	time(&end);
+
+	stats.raRunTime += difftime(end,start);
+
+	return kPath;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	calculatePaths
+// Description:		Calculates the k shortest paths from src to dest
+//					with the current routing algorithm. Called with
+//					the context of a speculation helper when the
+//					paths are calculated ahead of time.
+//
+///////////////////////////////////////////////////////////////////
+kShortestPathReturn* Thread::calculatePaths(unsigned short int src, unsigned short int dest, unsigned short int probesToSend, SimulationContext* ctx)
+{
+	kShortestPathReturn* kPath;
+
 	if(CurrentRoutingAlgorithm == PABR)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_PAR_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_PAR_path(src,dest,probesToSend,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == SHORTEST_PATH)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_SP_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_SP_path(src,dest,probesToSend,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == LORA)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_LORA_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_LORA_path(src,dest,probesToSend,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == IMPAIRMENT_AWARE)
 	{
-		kPath = threadZero->getResourceManager()->calculate_IA_path(
-			cre->sourceRouterIndex,cre->destinationRouterIndex,controllerIndex);
+		kPath = threadZero->getResourceManager()->calculate_IA_path(src,dest,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == Q_MEASUREMENT)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_QM_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_QM_path(src,dest,probesToSend,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == ADAPTIVE_QoS)
 	{
-		if(getRouterAt(cre->sourceRouterIndex)->getQualityFailures() >=
-		getRouterAt(cre->sourceRouterIndex)->getWaveFailures())
+		if(getRouterAt(src)->getQualityFailures() >=
+		getRouterAt(src)->getWaveFailures())
 		{
 			kPath = threadZero->getResourceManager()->
-				calculate_QM_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-				probesToSend,controllerIndex);
+				calculate_QM_path(src,dest,probesToSend,ctx);
 		}
 		else
 		{
 			kPath = threadZero->getResourceManager()->
-				calculate_AQoS_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-				probesToSend,controllerIndex);
+				calculate_AQoS_path(src,dest,probesToSend,ctx);
 		}
 	}
 	else if(CurrentRoutingAlgorithm == DYNAMIC_PROGRAMMING)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_DP_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_DP_path(src,dest,probesToSend,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == ACO)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_ACO_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_ACO_path(src,dest,probesToSend,ctx);
 	}
 	else if(CurrentRoutingAlgorithm == MAX_MIN_ACO)
 	{
 		kPath = threadZero->getResourceManager()->
-			calculate_MM_ACO_path(cre->sourceRouterIndex,cre->destinationRouterIndex,
-			probesToSend,controllerIndex);
+			calculate_MM_ACO_path(src,dest,probesToSend,ctx);
 	}
 	else
 	{
@@ -2220,11 +3560,71 @@ kShortestPathReturn* Thread::getKShortestPaths(ConnectionRequestEvent *cre, unsi
 		exit(ERROR_ALGORITHM_INPUT);
 	}
 
-	time(&end);
+	return kPath;
+}
 
-	stats.raRunTime += difftime(end,start);
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	startRouteBudget
+// Description:		Starts the compute budget for the routing
+//					request that is about to be calculated.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::startRouteBudget()
+{
+	routeBudgetOps = 0;
+	routeBudgetCut = false;
 
-	return kPath;
+	routeBudgetLimit = 0;
+	if(threadZero->getQualityParams().RA_budget_ops > 0)
+		routeBudgetLimit = threadZero->getQualityParams().RA_budget_ops;
+
+	routeBudgetTime = threadZero->getQualityParams().RA_budget_time;
+	if(routeBudgetTime > 0.0)
+		routeBudgetStart = getWallClock();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	stopRouteBudget
+// Description:		Stops the compute budget once the routing
+//					request has been calculated, so paths that are
+//					calculated outside of a request are not cut.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::stopRouteBudget()
+{
+	routeBudgetLimit = 0;
+	routeBudgetTime = 0.0;
+	routeBudgetCut = false;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	chargeRouteBudget
+// Description:		Charges ops operations to the compute budget
+//					of the current routing request. Returns true
+//					once the budget has run out, in which case the
+//					routing algorithm should return the best paths
+//					it has found so far.
+//
+///////////////////////////////////////////////////////////////////
+bool Thread::chargeRouteBudget(unsigned int ops)
+{
+	if(routeBudgetCut == true)
+		return true;
+
+	routeBudgetOps += ops;
+
+	if(routeBudgetLimit > 0 && routeBudgetOps >= routeBudgetLimit)
+		routeBudgetCut = true;
+	else if(routeBudgetTime > 0.0 && getWallClock() - routeBudgetStart >= routeBudgetTime)
+		routeBudgetCut = true;
+
+	if(routeBudgetCut == true)
+		++stats.raBudgetCuts;
+
+	return routeBudgetCut;
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -2517,6 +3917,9 @@ void Thread::sendProbes(ConnectionRequestEvent *cre, kShortestPathReturn *kPath,
 			event->e_time = getGlobalTime() + calculateDelay(probe->connectionPath[0]->getNumberOfSpans());
 			event->e_data = probe;
 
+			if(threadZero->getQualityParams().probe_fusion == true)
+				event->e_time = fuseProbeHops(probe,event->e_time);
+
 			queue->addEvent(*event);
 
 			delete event;
@@ -2589,6 +3992,56 @@ double Thread::calculateDelay(unsigned short int spans)
 	}
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	fuseProbeHops
+// Description:		Moves a probe to the last hop of its path and
+//					returns the time it reaches the destination.
+//					A probe in transit leaves the link state alone,
+//					so only the hop at the destination needs an
+//					event. The delays are added one hop at a time,
+//					the same as the events would have.
+//
+///////////////////////////////////////////////////////////////////
+double Thread::fuseProbeHops(CreateConnectionProbeEvent* ccpe, double time)
+{
+	while(ccpe->numberOfHops + 1 < ccpe->connectionLength)
+	{
+		++ccpe->numberOfHops;
+		++stats.fusedHops;
+
+		time += calculateDelay(ccpe->connectionPath[ccpe->numberOfHops]->getNumberOfSpans());
+	}
+
+	return time;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	fuseNextHop
+// Description:		Determines if the next hop of a message that
+//					changes the link state can be handled without
+//					an event. This is only the case when every
+//					queued event, and so every event that could
+//					touch the edges of the path, comes after it.
+//					The simulation time is moved to the hop if so.
+//
+///////////////////////////////////////////////////////////////////
+bool Thread::fuseNextHop(double time)
+{
+	if(threadZero->getQualityParams().probe_fusion == false)
+		return false;
+
+	if(queue->getSize() > 0 && queue->getNextTime() <= time)
+		return false;
+
+	++stats.fusedHops;
+
+	setGlobalTime(time);
+
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	sendResponse
@@ -2739,6 +4192,39 @@ int Thread::otherResponse(CreateConnectionProbeEvent* probe)
 	return -1;
 }
 
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addEstablishedConnection
+// Description:		Adds the lightpath of a new connection to the
+//					edges on its path, so its Q-factor is kept up
+//					to date.
+//
+///////////////////////////////////////////////////////////////////
+void Thread::addEstablishedConnection(Edge **connectionPath, unsigned short int connectionLength, short int wavelength, double duration)
+{
+	EstablishedConnection* ec = new EstablishedConnection();
+
+	ec->connectionLength = connectionLength;
+	ec->connectionPath = connectionPath;
+	ec->wavelength = wavelength;
+	ec->connectionStartTime = getGlobalTime();
+	ec->connectionEndTime = getGlobalTime() + duration;
+
+	if(threadZero->getQualityParams().q_factor_stats == true)
+	{
+		ec->QFactors = new vector<double>;
+		ec->QTimes = new vector<double>;
+		ec->variantQFactors = threadZero->getQualityParams().Q_variants > 0 ? new vector<float> : 0;
+	}
+
+	threadZero->getResourceManager()->init_lightpath_noise(ec);
+
+	for(unsigned int p = 0; p < ec->connectionLength; ++p)
+	{
+		ec->connectionPath[p]->insertEstablishedConnection(ec);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Function Name:	updateQMDegredation
@@ -2755,7 +4241,7 @@ void Thread::updateQMDegredation(Edge **connectionPath, unsigned short int conne
 
 	for(unsigned short int p = 0; p < connectionLength; ++p)
 	{
-		connectionPath[p]->updateQMDegredation(controllerIndex, wavelength);
+		connectionPath[p]->updateQMDegredation(context, wavelength);
 	}
 
 	time(&end);
@@ -2773,7 +4259,7 @@ void Thread::updateQFactorStats(Edge **connectionPath, unsigned short int connec
 {
 	for(unsigned short int p = 0; p < connectionLength ; ++p)
 	{
-		connectionPath[p]->updateQFactorStats(controllerIndex, wavelength);
+		connectionPath[p]->updateQFactorStats(context, wavelength);
 	}
 }
 
@@ -2885,3 +4371,48 @@ void Thread::saveThread(char* dir)
 		routers[r]->saveData(allName);
 }
 #endif
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	addResult
+// Description:		Adds one result of the simulation to the lists
+//					handed to the ReplicationStats.
+//
+///////////////////////////////////////////////////////////////////
+static void addResult(vector<string> &names, vector<double> &values, const char* name, double value)
+{
+	names.push_back(string(name));
+	values.push_back(value);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	fillVariants
+// Description:		Fills the values of the variants past the end of
+//					a list with its last value, or with the value of
+//					the simulation when the list is empty.
+//
+///////////////////////////////////////////////////////////////////
+static void fillVariants(float* list, unsigned short int count, unsigned short int variants, float base)
+{
+	for(unsigned short int v = count; v < variants; ++v)
+		list[v] = count == 0 ? base : list[count - 1];
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	mixSeed
+// Description:		Scrambles a 64 bit value into an odd 32 bit
+//					seed (SplitMix64 finalizer), so nearby inputs
+//					give unrelated random streams.
+//
+///////////////////////////////////////////////////////////////////
+static unsigned int mixSeed(boost::uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	x = x ^ (x >> 31);
+
+	return static_cast<unsigned int>(x >> 32) | 1;
+}
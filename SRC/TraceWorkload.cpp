@@ -0,0 +1,296 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      TraceWorkload.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the TraceReader and
+//					TraceRecorder classes. The TraceReader only keeps a window
+//					of TRACE_WINDOW_SIZE bytes mapped and moves it forward as
+//					the requests are read, so the operating system pages the
+//					trace in as it is replayed.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, replay of binary arrival traces.
+//
+// ____________________________________________________________________________
+
+#include "ErrorCodes.h"
+#include "Thread.h"
+#include "TraceWorkload.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+extern Thread* threadZero;
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	TraceReader
+// Description:		Constructor that opens the trace file and checks
+//					its header.
+//
+///////////////////////////////////////////////////////////////////
+TraceReader::TraceReader(const char* f)
+{
+	char buffer[250];
+
+	window = 0;
+	windowStart = 0;
+	windowLength = 0;
+
+#ifdef _WIN32
+	file = CreateFileA(f,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+
+	LARGE_INTEGER size;
+
+	if(file == INVALID_HANDLE_VALUE || GetFileSizeEx(file,&size) == 0)
+	{
+		sprintf(buffer,"ERROR: Unable to open the %s trace!!!",f);
+		threadZero->recordEvent(buffer,true,0);
+		exit(ERROR_TRACE_INPUT);
+	}
+
+	fileSize = size.QuadPart;
+
+	mapping = CreateFileMapping(file,NULL,PAGE_READONLY,0,0,NULL);
+
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	granularity = info.dwAllocationGranularity;
+#else
+	file = open(f,O_RDONLY);
+
+	struct stat size;
+
+	if(file < 0 || fstat(file,&size) != 0)
+	{
+		sprintf(buffer,"ERROR: Unable to open the %s trace!!!",f);
+		threadZero->recordEvent(buffer,true,0);
+		exit(ERROR_TRACE_INPUT);
+	}
+
+	fileSize = size.st_size;
+
+	granularity = sysconf(_SC_PAGESIZE);
+#endif
+
+	if(fileSize < sizeof(TraceHeader))
+	{
+		sprintf(buffer,"ERROR: The %s trace has no header!!!",f);
+		threadZero->recordEvent(buffer,true,0);
+		exit(ERROR_TRACE_INPUT);
+	}
+
+	mapWindow(0);
+
+	TraceHeader header;
+	memcpy(&header,window,sizeof(TraceHeader));
+
+	if(memcmp(header.magic,TRACE_MAGIC,4) != 0 || header.version != TRACE_VERSION || header.recordSize != sizeof(TraceRecord))
+	{
+		sprintf(buffer,"ERROR: The %s file is not a version %d trace!!!",f,TRACE_VERSION);
+		threadZero->recordEvent(buffer,true,0);
+		exit(ERROR_TRACE_INPUT);
+	}
+
+	numberOfRecords = (fileSize - sizeof(TraceHeader)) / sizeof(TraceRecord);
+	nextRecord = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~TraceReader
+// Description:		Unmaps the window and closes the trace file.
+//
+///////////////////////////////////////////////////////////////////
+TraceReader::~TraceReader()
+{
+	unmapWindow();
+
+#ifdef _WIN32
+	CloseHandle(mapping);
+	CloseHandle(file);
+#else
+	close(file);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	rewind
+// Description:		Starts reading from the first request again.
+//
+///////////////////////////////////////////////////////////////////
+void TraceReader::rewind()
+{
+	nextRecord = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	next
+// Description:		Copies the next request into r, returns false
+//					when the trace has no more requests.
+//
+///////////////////////////////////////////////////////////////////
+bool TraceReader::next(TraceRecord &r)
+{
+	if(nextRecord >= numberOfRecords)
+		return false;
+
+	boost::uint64_t offset = sizeof(TraceHeader) + nextRecord * sizeof(TraceRecord);
+
+	if(offset < windowStart || offset + sizeof(TraceRecord) > windowStart + windowLength)
+		mapWindow(offset);
+
+	memcpy(&r,window + (offset - windowStart),sizeof(TraceRecord));
+
+	++nextRecord;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	mapWindow
+// Description:		Maps the window of the trace that holds the
+//					given offset, starting at the page before it.
+//
+///////////////////////////////////////////////////////////////////
+void TraceReader::mapWindow(boost::uint64_t offset)
+{
+	unmapWindow();
+
+	windowStart = offset - offset % granularity;
+	windowLength = TRACE_WINDOW_SIZE;
+
+	//The request at offset has to fit even when it is close to the end of the window
+	if(windowLength < offset - windowStart + sizeof(TraceRecord))
+		windowLength = offset - windowStart + sizeof(TraceRecord);
+
+	if(windowLength > fileSize - windowStart)
+		windowLength = fileSize - windowStart;
+
+#ifdef _WIN32
+	window = static_cast<char*>(MapViewOfFile(mapping,FILE_MAP_READ,DWORD(windowStart >> 32),
+		DWORD(windowStart & 0xFFFFFFFF),SIZE_T(windowLength)));
+
+	if(window == NULL)
+#else
+	void* view = mmap(0,size_t(windowLength),PROT_READ,MAP_SHARED,file,off_t(windowStart));
+
+	if(view == MAP_FAILED)
+		window = 0;
+	else
+	{
+		window = static_cast<char*>(view);
+		madvise(view,size_t(windowLength),MADV_SEQUENTIAL);
+	}
+
+	if(window == 0)
+#endif
+	{
+		threadZero->recordEvent("ERROR: Unable to map the trace into memory!!!",true,0);
+		exit(ERROR_TRACE_INPUT);
+	}
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	unmapWindow
+// Description:		Unmaps the current window of the trace.
+//
+///////////////////////////////////////////////////////////////////
+void TraceReader::unmapWindow()
+{
+	if(window == 0)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(window);
+#else
+	munmap(window,size_t(windowLength));
+#endif
+
+	window = 0;
+	windowStart = 0;
+	windowLength = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	TraceRecorder
+// Description:		Constructor that creates the trace file and
+//					writes its header.
+//
+///////////////////////////////////////////////////////////////////
+TraceRecorder::TraceRecorder(const char* f)
+{
+	numberOfRecords = 0;
+
+	file = fopen(f,"wb");
+
+	if(file == 0)
+	{
+		char buffer[250];
+		sprintf(buffer,"ERROR: Unable to create the %s trace!!!",f);
+		threadZero->recordEvent(buffer,true,0);
+		exit(ERROR_TRACE_OUTPUT);
+	}
+
+	TraceHeader header;
+
+	memcpy(header.magic,TRACE_MAGIC,4);
+	header.version = TRACE_VERSION;
+	header.recordSize = sizeof(TraceRecord);
+	header.reserved = 0;
+
+	fwrite(&header,sizeof(TraceHeader),1,file);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~TraceRecorder
+// Description:		Flushes and closes the trace file.
+//
+///////////////////////////////////////////////////////////////////
+TraceRecorder::~TraceRecorder()
+{
+	fclose(file);
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	record
+// Description:		Adds one request to the end of the trace.
+//
+///////////////////////////////////////////////////////////////////
+void TraceRecorder::record(double arrival, double holding, unsigned short int src, unsigned short int dest)
+{
+	TraceRecord r;
+
+	r.arrivalTime = arrival;
+	r.holdingTime = holding;
+	r.sourceRouterIndex = src;
+	r.destinationRouterIndex = dest;
+	r.reserved = 0;
+
+	if(fwrite(&r,sizeof(TraceRecord),1,file) != 1)
+	{
+		threadZero->recordEvent("ERROR: Unable to write to the trace!!!",true,0);
+		exit(ERROR_TRACE_OUTPUT);
+	}
+
+	++numberOfRecords;
+}
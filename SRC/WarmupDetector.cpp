@@ -0,0 +1,165 @@
+// ____________________________________________________________________________
+//
+//  General Information:
+//
+//  File Name:      WarmupDetector.cpp
+//  Author:         RWASimulator contributors
+//  Project:        RWASimulator
+//
+//  Description:    The file contains the implementation of the WarmupDetector
+//					class. The MSER-5 rule is tried once the series holds
+//					firstCheck batches and again every time it doubles. The
+//					truncation point is accepted when it lies in the first half
+//					of the series, otherwise the transient is taken to still be
+//					running.
+//
+//  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//  Revision History:
+//
+//  10/19/2026	v1.0	Initial Version, MSER-5 warm up detection.
+//
+// ____________________________________________________________________________
+
+#include "WarmupDetector.h"
+
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	WarmupDetector
+// Description:		Constructor that takes the number of batches in
+//					the series before the first MSER-5 test.
+//
+///////////////////////////////////////////////////////////////////
+WarmupDetector::WarmupDetector(unsigned int check)
+{
+	firstCheck = check < 4 ? 4 : check;
+
+	reset();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	~WarmupDetector
+// Description:		Default destructor with no arguements.
+//
+///////////////////////////////////////////////////////////////////
+WarmupDetector::~WarmupDetector()
+{
+	batches.clear();
+	snapshots.clear();
+	times.clear();
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	reset
+// Description:		Clears the series before a new simulation.
+//
+///////////////////////////////////////////////////////////////////
+void WarmupDetector::reset()
+{
+	nextCheck = firstCheck;
+
+	lastFinished = 0;
+	lastBlocked = 0;
+
+	batches.clear();
+	snapshots.clear();
+	times.clear();
+
+	detected = false;
+	truncationRequests = 0;
+	truncationTime = 0.0;
+	memset(&truncationStats,0,sizeof(GlobalStats));
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	update
+// Description:		Takes the number of finished and blocked
+//					requests so far with the current statistics.
+//					Returns true once when the end of the warm up
+//					is found, getTruncationStats then holds the
+//					statistics to remove.
+//
+///////////////////////////////////////////////////////////////////
+bool WarmupDetector::update(unsigned int finished, unsigned int blocked, const GlobalStats &s, double time)
+{
+	if(detected == true || finished - lastFinished < MSER_BATCH_SIZE)
+		return false;
+
+	batches.push_back(double(blocked - lastBlocked) / double(finished - lastFinished));
+	snapshots.push_back(s);
+	times.push_back(time);
+
+	lastFinished = finished;
+	lastBlocked = blocked;
+
+	if(batches.size() < nextCheck)
+		return false;
+
+	unsigned int d = mser();
+
+	if(d > batches.size() / 2)
+	{
+		nextCheck *= 2;
+		return false;
+	}
+
+	detected = true;
+
+	if(d > 0)
+	{
+		truncationStats = snapshots[d - 1];
+		truncationTime = times[d - 1];
+		truncationRequests = truncationStats.ConnectionRequests;
+	}
+
+	batches.clear();
+	snapshots.clear();
+	times.clear();
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////
+//
+// Function Name:	mser
+// Description:		Returns the number of batches to remove, the d
+//					that minimizes the variance of the mean of the
+//					batches left over (n-d)^2.
+//
+///////////////////////////////////////////////////////////////////
+unsigned int WarmupDetector::mser()
+{
+	unsigned int n = static_cast<unsigned int>(batches.size());
+
+	double sum = 0.0;
+	double squares = 0.0;
+
+	double best = 0.0;
+	unsigned int bestD = n;
+
+	//Walk back from the end so the sums of the batches left over build up
+	for(unsigned int d = n; d-- > 0;)
+	{
+		sum += batches[d];
+		squares += batches[d] * batches[d];
+
+		double m = double(n - d);
+
+		if(n - d < 2)
+			continue;
+
+		double value = (squares - sum * sum / m) / (m * m);
+
+		if(bestD == n || value <= best)
+		{
+			best = value;
+			bestD = d;
+		}
+	}
+
+	return bestD;
+}